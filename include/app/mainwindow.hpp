@@ -47,6 +47,10 @@ public:
     bool saveFile(const QString &path);
     bool loadFile(const QString &path);
 
+    // Records a trace, written to path when recording stops or the window closes.
+    // Without path the file is asked for when recording stops.
+    void startTrace(const QString &path = QString());
+
 protected:
     void closeEvent(QCloseEvent *event);
 
@@ -68,6 +72,8 @@ private slots:
 
     void stlExport();
 
+    void recordTrace(bool record);
+
     void about();
 
     bool maybeSave();
@@ -89,11 +95,13 @@ private:
 
     bool _dirty;
     QFileInfo _currentFile;
+    QString _tracePath;
 
     QMenu *fileMenu;
     QMenu *importMenu;
     QMenu *exportMenu;
     QMenu *threedMenu;
+    QMenu *viewMenu;
     QMenu *aboutMenu;
 
     QAction *newAct;
@@ -115,6 +123,9 @@ private:
 
     QAction *quitAct;
 
+    QAction *perfHudAct;
+    QAction *recordTraceAct;
+
     QAction *aboutAct;
     QAction *aboutQtAct;
 
@@ -124,6 +135,7 @@ private:
     void createMenus();
 
     bool loadFileToJson(const QString &path, QJsonObject &jObj);
+    bool writeTrace(const QString &path);
 
     void setCurrentFilePath(const QString &path);
     QString askSaveFileName(const QString &extension, const QString &fileFilter, const QString &title = tr("Save As"));
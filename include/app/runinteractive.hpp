@@ -29,7 +29,7 @@
 QTextStream out(stdout);
 #endif
 
-int runInteractive(QApplication &app, const QUrl &baseUrl, const QString &filePath)
+int runInteractive(QApplication &app, const QUrl &baseUrl, const QString &filePath, const QString &tracePath = QString())
 {
     out << "Starting finFoil " << version.toString() << endl
         << "git-hash " << version.commit() << endl;
@@ -38,6 +38,10 @@ int runInteractive(QApplication &app, const QUrl &baseUrl, const QString &filePa
 
     w.show();
 
+    // Trace from startup to include loading the file
+    if (!tracePath.isEmpty())
+        w.startTrace(tracePath);
+
     if (!filePath.isEmpty())
         w.loadFile(filePath);
 
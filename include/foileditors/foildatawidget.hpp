@@ -69,6 +69,7 @@ namespace foileditors
 
         QComboBox* _unitSelector;
         QSpinBox* _layerEdit;
+        QDoubleSpinBox* _toleranceEdit;
         qt::units::UnitDoubleSpinbox<qt::units::Length>* _depthEdit;
         qt::units::UnitDoubleSpinbox<qt::units::Length>* _thicknessEdit;
         qt::units::UnitDoubleSpinbox<qt::units::Length>* _minThickEdit;
@@ -85,6 +86,7 @@ namespace foileditors
     private slots:
         void onFoilCalculated();
         void onLayerChange(int layerCount);
+        void onToleranceChange(double tolerancePercent);
         void onUnitSystemChange(const QString &system, bool showEvent = false);
         void onDepthChange(qt::units::IQuantity *depth);
         void onThicknessChange(qt::units::IQuantity *thickness);
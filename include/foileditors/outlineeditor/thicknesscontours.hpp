@@ -28,6 +28,11 @@
 
 #include <QGraphicsObject>
 #include <QThreadPool>
+#include <QHash>
+#include <QPair>
+#include <QPixmap>
+#include <QTransform>
+#include <memory>
 
 using namespace patheditor;
 
@@ -41,13 +46,55 @@ namespace foileditors
         virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
         virtual QRectF boundingRect() const;
 
-        virtual ~ThicknessContours() {}
+        // Timings of the last paint [ns]
+        struct PaintTimes
+        {
+            qint64 render; // rendering the contours in new tiles
+            qint64 blit;   // drawing the tiles
+            int renderedTiles;
+            int cachedTiles;
+        };
+        PaintTimes paintTimes() const;
+
+        // Paints the contours as cubic Béziers fitted to the screen tolerance
+        // instead of simplified polylines. Off by default, fitting runs while painting.
+        void setCurveFitting(bool fit);
+        bool curveFitting() const;
+        // Largest distance of the calculated contours to the painted curves [scene units]
+        qreal fitError() const;
+
+        virtual ~ThicknessContours();
 
     private:
         foillogic::Side::e _side;
         bool _nextDetailed;
 
         foillogic::FoilCalculator* _calculator;
+
+        // The contours are rendered once per calculation in tiles of the zoom
+        // (the world transform without translation) they were rendered at,
+        // TILE_SIZE logical pixels wide at the device pixel ratio. Scrolling and
+        // unrelated repaints only draw the tiles.
+        QTransform _tileTransform;
+        QHash<QPair<int, int>, QPixmap> _tiles; // by tile column and row
+        PaintTimes _paintTimes;
+
+        // Extent of the outline the contours were calculated on
+        QRectF _boundingRect;
+
+        // Contours of the last calculation simplified to the zoom, within _pathTolerance [scene units]
+        QList<std::shared_ptr<QPainterPath> > _paths;
+        qreal _pathTolerance;
+        bool _curveFitting;
+        qreal _fitError;
+
+        // Colours of the contours, and of the bands of the last release calculation
+        QList<QColor> _contourColors;
+        std::shared_ptr<const foillogic::ContourBands> _bands;
+        QList<QColor> _bandColors;
+
+        void renderContours(QPainter *painter);
+        void invalidateTiles();
     };
 }
 
@@ -61,6 +61,7 @@ namespace foileditors
     private slots:
         void update();
         void modeChanged(int mode);
+        void onPathChange(Path* path);
     };
 }
 
@@ -0,0 +1,60 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef CONTOURBANDS_HPP
+#define CONTOURBANDS_HPP
+
+#include <memory>
+#include <QColor>
+#include <QList>
+#include <QPainterPath>
+
+namespace foillogic
+{
+    //
+    // Nested contours split in non-overlapping bands, the rings between
+    // consecutive contours. Filling each band once with composite() of the
+    // contour colours gives the same result as stacking the translucent
+    // contours, without overdraw.
+    //
+    class ContourBands
+    {
+    public:
+        explicit ContourBands(const QList<std::shared_ptr<QPainterPath> > &contours);
+
+        // Bands from the outermost contour inwards
+        int count() const;
+        const QPainterPath& band(int i) const;
+
+        // Indices in contours of the contours covering band i, in list order
+        QList<int> covering(int i) const;
+
+        // Colour of colors drawn on top of each other in order (source over)
+        static QColor composite(const QList<QColor> &colors);
+
+    private:
+        QList<QPainterPath> _bands;
+        QList<int> _nesting; // contour indices, outermost first
+    };
+}
+
+#endif // CONTOURBANDS_HPP
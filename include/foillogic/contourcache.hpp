@@ -0,0 +1,89 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef CONTOURCACHE_HPP
+#define CONTOURCACHE_HPP
+
+#include "foillogic/fwd/foillogicfwd.hpp"
+
+#include <memory>
+#include <mutex>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+namespace foillogic
+{
+    //
+    // Persistent cache of calculation results, one file per key in a cache
+    // directory. Contours are stored once as single precision points, shared
+    // contours are references to the first. The least recently used files are
+    // removed once the stored files exceed the maximum size, down to 3/4 of it.
+    // Loads and stores do file I/O, call them from worker threads. They are
+    // safe to call concurrently.
+    //
+    class ContourCache
+    {
+    public:
+        struct Entry
+        {
+            QList<std::shared_ptr<const ContourPolyline> > topContours;
+            QList<std::shared_ptr<const ContourPolyline> > botContours;
+            qreal area;      // [m^2]
+            qreal sweep;     // [rad]
+            qreal thickness; // [m], AR enforced thickness
+        };
+
+        explicit ContourCache(const QString &directory);
+
+        // Cache in the application cache location, shared by all calculators
+        static std::shared_ptr<ContourCache> standard();
+
+        // Content hash of everything a calculation depends on
+        static QByteArray key(const FoilGeometry &geometry, const QList<qreal> &contourThicknesses,
+                              qreal tolerance, size_t resolution);
+
+        QString directory() const;
+
+        // [bytes]
+        qint64 maxSize() const;
+        void setMaxSize(qint64 maxSize);
+
+        bool load(const QByteArray &key, Entry *entry) const;
+        bool store(const QByteArray &key, const Entry &entry) const;
+
+    private:
+        QString _directory;
+        qint64 _maxSize;
+
+        // Total size of the files [bytes], -1 until the first store lists them
+        mutable std::mutex _sizeMutex;
+        mutable qint64 _size;
+
+        QString filePath(const QByteArray &key) const;
+        // Totals the files, removes the least recently used ones beyond the maximum size.
+        // Called with _sizeMutex locked.
+        void prune() const;
+    };
+}
+
+#endif // CONTOURCACHE_HPP
@@ -16,12 +16,17 @@
 
 #include <QRunnable>
 #include <QPointF>
+#include <QtMath>
+#include <memory>
+#include <vector>
 
 #include <boost/math/tools/roots.hpp>
 #include "patheditor/pathfunctors.hpp"
 #include "hrlib/math/spline.hpp"
 #include "patheditor/path.hpp"
 #include "foillogic/samplers.hpp"
+#include "hrlib/concurrent/scheduler.hpp"
+#include "hrlib/instrument/instrument.hpp"
 
 using namespace patheditor;
 using namespace boost::math;
@@ -29,6 +34,16 @@ using namespace boost::math::tools;
 
 namespace foillogic
 {
+    // ContourCalculator stages, see hrlib::instrument. Sampling is timed in initialSections().
+    namespace contourstage
+    {
+        inline hrlib::instrument::Timer sampling("ContourCalculator::sampling");
+        inline hrlib::instrument::Timer thickness("ContourCalculator::thickness");
+        inline hrlib::instrument::Timer roots("ContourCalculator::roots");
+        inline hrlib::instrument::Timer spline("ContourCalculator::spline");
+        inline hrlib::instrument::Counter sections("ContourCalculator::sections");
+    }
+
     inline bool isInRange(qreal x, qreal a, qreal b)
     {
         // For consistency, the boundaries are not considered in range
@@ -39,24 +54,26 @@ namespace foillogic
         return false;
     }
 
-    inline bool includePoint(QPointF *prevPoint, QPointF *curPoint)
-    {
-        if (!prevPoint)
-            return true;
-
-        QPointF diff = (*curPoint - *prevPoint);
-
-        if (qAbs(diff.x()/diff.y()) > 1)
-            return true;
-
-        return false;
-    }
-
     template<typename Target>
     class ContourCalculator : public QRunnable
     {
         enum SplineFunction { bSpline, overhauser };
 
+        // A cross section of the fin at normalised height h, valid when the
+        // contour crosses it
+        struct Section
+        {
+            qreal h;
+            bool valid;
+            QPointF leadingEdge;
+            QPointF trailingEdge;
+        };
+
+        // Sections of the first pass, refined where the contour deviates
+        // from the chord between neighbouring sections
+        static const size_t initialSectionCount = 32;
+        static const int maxRefineDepth = 8;
+
         Target *_result;
         qreal _percContourHeight;
         const patheditor::IPath* _outline;
@@ -65,142 +82,167 @@ namespace foillogic
 
         bool _arEnforced;
 
-        size_t _sectionCount;
+        qreal _tolerance;
         size_t _resolution;
         qreal _tTol;
 
+        std::shared_ptr<const std::vector<qreal>> _initialSections;
+        std::shared_ptr<const ThicknessLookup> _thicknessLookup;
+        size_t _sectionCount;
+
+        size_t _sectionChunks;
+        hrlib::concurrent::Priority::e _priority;
+
+        qreal _refinedMin, _refinedMax;
+
+        // Foil properties shared by all sections
+        qreal _t_top, _y_top;
+        qreal _t_profileTop, _y_profileTop, _y_profileBot;
+        qreal _profileLength, _height, _maxThickness, _baseChord;
+
     public:
+        //
+        // tolerance: maximum deviation of the contour from the polyline
+        //            through its sections, relative to the outline height
+        // initialSections: coarse sections shared between the contours of a
+        //                  calculation, see initialSections(), calculated if null
+        // thicknessLookup: lookup on the thickness profile, shared like initialSections
+        //
         explicit ContourCalculator(Target* result, qreal percContourHeight,
                                    const IPath* outline, const IPath* thickness, const IPath* profile,
                                    bool arEnforced,
-                                   size_t sectionCount = 512, size_t resolution = 512) :
+                                   qreal tolerance = 0.001, size_t resolution = 512,
+                                   std::shared_ptr<const std::vector<qreal>> initialSections = nullptr,
+                                   std::shared_ptr<const ThicknessLookup> thicknessLookup = nullptr) :
           _result(result), _percContourHeight(percContourHeight),
           _outline(outline), _thickness(thickness), _profile(profile),
           _arEnforced(arEnforced),
-          _sectionCount(sectionCount), _resolution(resolution), _tTol(0.00001)
+          _tolerance(tolerance), _resolution(resolution), _tTol(0.00001),
+          _initialSections(initialSections), _thicknessLookup(thicknessLookup), _sectionCount(0),
+          _sectionChunks(1), _priority(hrlib::concurrent::Priority::Release),
+          _refinedMin(0), _refinedMax(1)
         {}
 
-        virtual void run()
+        //
+        // Splits the section evaluation of run() in chunks running on the
+        // shared scheduler, the contour is assembled once all chunks are done.
+        // chunks 1 (the default) evaluates all sections on the calling thread.
+        //
+        void setSectionChunks(size_t chunks, hrlib::concurrent::Priority::e priority = hrlib::concurrent::Priority::Release)
         {
-            qreal t_profileTop;
-            qreal y_profileTop;
+            _sectionChunks = qMax(chunks, size_t(1));
+            _priority = priority;
+        }
 
-            y_profileTop = _profile->maxY(&t_profileTop);
-            qreal profileLength = _profile->pointAtPercent(1).x();
+        //
+        // Only refines the intervals overlapping normalised heights [hMin, hMax],
+        // e.g. the visible part of the outline. Elsewhere the contour follows
+        // the coarse sections. Defaults to [0, 1].
+        //
+        void setRefinedRange(qreal hMin, qreal hMax)
+        {
+            _refinedMin = hMin;
+            _refinedMax = hMax;
+        }
 
+        // Normalised heights of the coarse sections on the outline and thickness features
+        static std::vector<qreal> initialSections(const IPath* outline, const IPath* thickness, bool arEnforced)
+        {
+            // Timed here, callers calculate them once for all contours of a calculation
+            hrlib::instrument::Zone zone(contourstage::sampling);
 
-            //
-            // discretise and normalise the thickness profile in different cross sections
-            //
+            qreal height = thickness->pointAtPercent(1).x();
 
             const double mult = 2;
             FeatureSampler featureSampler;
-            featureSampler.addFeatureSamples(_outline, [](QPointF p){return p.y();}, _sectionCount);
-            if (!_arEnforced) // Currently no need to add features if not ar enforced, might be revisited when variable AR profile
-              featureSampler.addFeatureSamples(_thickness, [](QPointF p){return p.x();}, _sectionCount);
-            featureSampler.addUniformSamples(0, _thickness->pointAtPercent(1).x(), _sectionCount*mult);
-            std::vector<qreal> sectionHeightArray = featureSampler.sampleAt(_sectionCount);
-            std::vector<qreal> thicknessArray = sampleThickess(_thickness, sectionHeightArray);
+            featureSampler.addFeatureSamples(outline, [](QPointF p){return p.y();}, initialSectionCount);
+            if (!arEnforced) // Currently no need to add features if not ar enforced, might be revisited when variable AR profile
+              featureSampler.addFeatureSamples(thickness, [](QPointF p){return p.x();}, initialSectionCount);
+            featureSampler.addUniformSamples(0, height, initialSectionCount*mult);
+            std::vector<qreal> sectionHeightArray = featureSampler.sampleAt(initialSectionCount);
             // normalize
-            qreal height = _thickness->pointAtPercent(1).x();
-            qreal maxThickness = qMax(qAbs(_thickness->minY()), qAbs(_thickness->pointAtPercent(0).y()));
             for (qreal &h : sectionHeightArray) h/=height;
-            for (qreal &t : thicknessArray) t/=maxThickness;
-            qreal baseChord = _outline->pointAtPercent(1).x() - _outline->pointAtPercent(0).x();
+            // the samples stop short of the tip, end at the tip so the contour
+            // is refined up to where it closes
+            sectionHeightArray.push_back(1);
+            return sectionHeightArray;
+        }
 
+        virtual void run()
+        {
+            _y_profileTop = _profile->maxY(&_t_profileTop);
+            _profileLength = _profile->pointAtPercent(1).x();
 
-            //
-            // create the functors
-            //
+            // Set _t_profileTop to t_min of the profile for correct calculation of the Negative profile
+            _y_profileBot = 0;
+            if (_percContourHeight < 0)
+                _y_profileBot = _profile->minY(&_t_profileTop);
 
-            f_diffTol<qreal> tTolerance(_tTol);
-            f_ValueAtPercentPath<Y> yOutline(_outline);
-            f_ValueAtPercentPath<Y> yProfile(_profile);
+            _height = _thickness->pointAtPercent(1).x();
+            _maxThickness = qMax(qAbs(_thickness->minY()), qAbs(_thickness->pointAtPercent(0).y()));
+            _baseChord = _outline->pointAtPercent(1).x() - _outline->pointAtPercent(0).x();
 
 
             //
             // find the top of the outline
             //
 
-            qreal t_top = 0.5; // start value
-            qreal y_top = _outline->maxY(&t_top);
+            _t_top = 0.5; // start value
+            _y_top = _outline->maxY(&_t_top);
 
 
             //
-            // calculate the contour points
+            // refine between the coarse sections until the tolerance is met
             //
 
-            std::vector<QPointF*> leadingEdgePnts;
-            std::vector<QPointF*> trailingEdgePnts;
-
-            QPointF outlineLeadingEdge, outlineTrailingEdge;
-            qreal leadingEdgePerc, trailingEdgePerc;
-            for (size_t i=0; i<_sectionCount; i++)
+            if (!_initialSections)
+                _initialSections = std::make_shared<const std::vector<qreal>>(initialSections(_outline, _thickness, _arEnforced));
+
+            // the initial sections are sorted, look up their thickness in a single walk
+            hrlib::instrument::Zone thicknessZone(contourstage::thickness);
+            if (!_thicknessLookup)
+                _thicknessLookup = std::make_shared<const ThicknessLookup>(_thickness);
+            std::vector<qreal> initialHeights(*_initialSections);
+            for (qreal &h : initialHeights) h*=_height;
+            std::vector<qreal> initialThicknesses = _thicknessLookup->sample(initialHeights);
+            thicknessZone.end();
+
+            std::vector<Section> initial(initialHeights.size());
+            forEachChunk(initial.size(), [&](size_t begin, size_t end) {
+                hrlib::instrument::Zone zone(contourstage::roots);
+                for (size_t i=begin; i<end; i++)
+                    initial[i] = evaluateSection((*_initialSections)[i], initialThicknesses[i]);
+            });
+
+            // refinement of an interval only depends on its bounding sections
+            size_t intervalCount = initial.empty() ? 0 : initial.size()-1;
+            std::vector<std::vector<Section>> refined(intervalCount);
+            forEachChunk(intervalCount, [&](size_t begin, size_t end) {
+                hrlib::instrument::Zone zone(contourstage::roots);
+                for (size_t i=begin; i<end; i++)
+                    if (initial[i+1].h >= _refinedMin && initial[i].h <= _refinedMax)
+                        refine(initial[i], initial[i+1], 0, refined[i]);
+            });
+
+            std::vector<Section> sections;
+            for (size_t i=0; i<initial.size(); i++)
             {
-              try
-                {
-                  yOutline.setOffset(sectionHeightArray[i] * y_top);
-
-                  qreal t_outlineLeadingEdge = bisect(yOutline, 0.0, t_top, tTolerance).first;
-                  qreal t_outlineTrailingEdge = bisect(yOutline, t_top, 1.0, tTolerance).first;
-                  outlineLeadingEdge = _outline->pointAtPercent(t_outlineLeadingEdge);
-                  outlineTrailingEdge = _outline->pointAtPercent(t_outlineTrailingEdge);
-
-                  qreal thicknessOffsetPercent = _percContourHeight / thicknessArray[i];
-
-                  if (_arEnforced) {
-                    // Modify thicknessOffsetPercent according to aspect ratio
-                    qreal chord = outlineTrailingEdge.x() - outlineLeadingEdge.x();
-                    thicknessOffsetPercent = _percContourHeight / (thicknessArray[i]*chord/baseChord);
-                  }
-
-                  qreal profileOffset = thicknessOffsetPercent * y_profileTop;
-                  yProfile.setOffset(profileOffset);
-
-                  // Set t_profileTop to t_min of the profile for correct calculation of the Negative profile
-                  qreal y_profileBot = 0;
-                  if (_percContourHeight < 0) {
-                    y_profileBot = _profile->minY(&t_profileTop);
-                  }
-
-                  if (!isInRange(profileOffset, y_profileBot, y_profileTop)) {
-                    leadingEdgePnts.push_back(0);
-                    trailingEdgePnts.push_back(0);
-                    continue;
-                  }
-
-                  qreal t_profileLE = bisect(yProfile, 0.0, t_profileTop, tTolerance).first;
-                  qreal t_profileTE = bisect(yProfile, t_profileTop, 1.0, tTolerance).first;
-                  leadingEdgePerc = _profile->pointAtPercent(t_profileLE).x() / profileLength;
-                  trailingEdgePerc = _profile->pointAtPercent(t_profileTE).x() / profileLength;
-                }
-                catch (evaluation_error &/*unused*/)
-                {
-                    // no result when bisect fails
-                    leadingEdgePnts.push_back(nullptr);
-                    trailingEdgePnts.push_back(nullptr);
-                    continue;
-                }
-
-                qreal xLE = outlineLeadingEdge.x();
-                qreal xTE = outlineTrailingEdge.x();
+                sections.push_back(initial[i]);
+                if (i < intervalCount)
+                    sections.insert(sections.end(), refined[i].begin(), refined[i].end());
+            }
+            refineCorners(sections);
+            _sectionCount = sections.size();
+            contourstage::sections.set(_sectionCount);
 
-                std::unique_ptr<QPointF> leadingEdgePnt(new QPointF(xLE +(leadingEdgePerc * (xTE - xLE)), outlineLeadingEdge.y()));
-                std::unique_ptr<QPointF> trailingEdgePnt(new QPointF(xLE +(trailingEdgePerc * (xTE - xLE)), outlineTrailingEdge.y()));
+            hrlib::instrument::Zone splineZone(contourstage::spline);
 
-                if (i%5 == 0)
-                {
-                    // Make sure that at least one in 5 points is added for spline evaluation
-                    leadingEdgePnts.push_back(leadingEdgePnt.release());
-                    trailingEdgePnts.push_back(trailingEdgePnt.release());
-                }
-                else if (includePoint(leadingEdgePnts.back(), leadingEdgePnt.get()) ||
-                         includePoint(trailingEdgePnts.back(), trailingEdgePnt.get()))
-                {
-                    // Only add point for spline evaluation when abs(x/y) > 1 (close to the tip)
-                    leadingEdgePnts.push_back(leadingEdgePnt.release());
-                    trailingEdgePnts.push_back(trailingEdgePnt.release());
-                }
+            std::vector<QPointF*> leadingEdgePnts;
+            std::vector<QPointF*> trailingEdgePnts;
+            for (Section &section : sections)
+            {
+                leadingEdgePnts.push_back(section.valid ? &section.leadingEdge : nullptr);
+                trailingEdgePnts.push_back(section.valid ? &section.trailingEdge : nullptr);
             }
 
             int pointCount = leadingEdgePnts.size();
@@ -220,15 +262,199 @@ namespace foillogic
                     }
                 }
             }
-
-            // cleanup
-            foreach (QPointF *point, leadingEdgePnts) if (point) delete point;
-            foreach (QPointF *point, trailingEdgePnts) if (point) delete point;
         }
 
+        // Number of sections used by the last run
+        size_t sectionCount() const { return _sectionCount; }
+
         virtual ~ContourCalculator() {}
 
     private:
+        // Calls f(begin, end) on consecutive index ranges covering [0, count)
+        template<typename F>
+        void forEachChunk(size_t count, F f)
+        {
+            size_t chunks = qMin(_sectionChunks, count);
+            if (chunks <= 1)
+            {
+                f(size_t(0), count);
+                return;
+            }
+
+            hrlib::concurrent::TaskGroup tasks;
+            for (size_t c=0; c<chunks; c++)
+            {
+                size_t begin = count*c/chunks;
+                size_t end = count*(c+1)/chunks;
+                tasks.run([&f, begin, end]() { f(begin, end); }, _priority);
+            }
+            tasks.wait();
+        }
+
+        Section evaluateSection(qreal h)
+        {
+            return evaluateSection(h, _thicknessLookup->thicknessAt(h * _height));
+        }
+
+        Section evaluateSection(qreal h, qreal thickness)
+        {
+            Section section = { h, false, QPointF(), QPointF() };
+
+            f_diffTol<qreal> tTolerance(_tTol);
+            f_ValueAtPercentPath<Y> yOutline(_outline);
+            f_ValueAtPercentPath<Y> yProfile(_profile);
+
+            QPointF outlineLeadingEdge, outlineTrailingEdge;
+            qreal leadingEdgePerc, trailingEdgePerc;
+            try
+            {
+                yOutline.setOffset(h * _y_top);
+
+                qreal t_outlineLeadingEdge = bisect(yOutline, 0.0, _t_top, tTolerance).first;
+                qreal t_outlineTrailingEdge = bisect(yOutline, _t_top, 1.0, tTolerance).first;
+                outlineLeadingEdge = _outline->pointAtPercent(t_outlineLeadingEdge);
+                outlineTrailingEdge = _outline->pointAtPercent(t_outlineTrailingEdge);
+
+                thickness /= _maxThickness;
+                qreal thicknessOffsetPercent = _percContourHeight / thickness;
+
+                if (_arEnforced) {
+                    // Modify thicknessOffsetPercent according to aspect ratio
+                    qreal chord = outlineTrailingEdge.x() - outlineLeadingEdge.x();
+                    thicknessOffsetPercent = _percContourHeight / (thickness*chord/_baseChord);
+                }
+
+                qreal profileOffset = thicknessOffsetPercent * _y_profileTop;
+                yProfile.setOffset(profileOffset);
+
+                if (!isInRange(profileOffset, _y_profileBot, _y_profileTop))
+                    return section;
+
+                qreal t_profileLE = bisect(yProfile, 0.0, _t_profileTop, tTolerance).first;
+                qreal t_profileTE = bisect(yProfile, _t_profileTop, 1.0, tTolerance).first;
+                leadingEdgePerc = _profile->pointAtPercent(t_profileLE).x() / _profileLength;
+                trailingEdgePerc = _profile->pointAtPercent(t_profileTE).x() / _profileLength;
+            }
+            catch (evaluation_error &/*unused*/)
+            {
+                // no result when bisect fails
+                return section;
+            }
+
+            qreal xLE = outlineLeadingEdge.x();
+            qreal xTE = outlineTrailingEdge.x();
+
+            section.valid = true;
+            section.leadingEdge = QPointF(xLE +(leadingEdgePerc * (xTE - xLE)), outlineLeadingEdge.y());
+            section.trailingEdge = QPointF(xLE +(trailingEdgePerc * (xTE - xLE)), outlineTrailingEdge.y());
+            return section;
+        }
+
+        // Distance of p to the point at fraction f of the chord from a to b
+        static qreal chordError(const QPointF &a, const QPointF &p, const QPointF &b, qreal f)
+        {
+            QPointF diff = p - (a + (b - a)*f);
+            return qSqrt(QPointF::dotProduct(diff, diff));
+        }
+
+        bool onChord(const Section &a, const Section &p, const Section &b, qreal f) const
+        {
+            qreal error = qMax(chordError(a.leadingEdge, p.leadingEdge, b.leadingEdge, f),
+                               chordError(a.trailingEdge, p.trailingEdge, b.trailingEdge, f));
+            return error <= _tolerance * _y_top;
+        }
+
+        // Appends the sections needed between a and b, in order of height.
+        // knownMid is the midpoint when already evaluated for the parent interval.
+        void refine(const Section &a, const Section &b, int depth, std::vector<Section> &sections,
+                    const Section *knownMid = nullptr)
+        {
+            if (depth >= maxRefineDepth || (!a.valid && !b.valid))
+                return;
+
+            Section mid = knownMid ? *knownMid : evaluateSection((a.h + b.h)/2);
+
+            // Always refine towards the end of a contour (e.g. the tip),
+            // otherwise only where the contour is not straight enough.
+            // A straight midpoint is confirmed at the quarter points, a feature
+            // off the midpoint (e.g. a corner of the outline) is missed otherwise.
+            if (a.valid && b.valid && mid.valid && onChord(a, mid, b, 0.5))
+            {
+                Section q1 = evaluateSection((3*a.h + b.h)/4);
+                Section q3 = evaluateSection((a.h + 3*b.h)/4);
+                if (q1.valid && q3.valid && onChord(a, q1, b, 0.25) && onChord(a, q3, b, 0.75))
+                    return;
+
+                refine(a, mid, depth+1, sections, &q1);
+                sections.push_back(mid);
+                refine(mid, b, depth+1, sections, &q3);
+                return;
+            }
+
+            refine(a, mid, depth+1, sections);
+            sections.push_back(mid);
+            refine(mid, b, depth+1, sections);
+        }
+
+        static qreal segmentDistance(const QPointF &p, const QPointF &a, const QPointF &b)
+        {
+            QPointF ab = b - a;
+            qreal length = QPointF::dotProduct(ab, ab);
+            qreal t = length > 0 ? qBound(qreal(0), QPointF::dotProduct(p - a, ab) / length, qreal(1)) : 0;
+            QPointF diff = p - (a + ab*t);
+            return qSqrt(QPointF::dotProduct(diff, diff));
+        }
+
+        // Distance of the B-spline point at b to the polyline a, b, c
+        static qreal splineError(const QPointF &a, const QPointF &b, const QPointF &c)
+        {
+            QPointF spline = (a + 4*b + c) / 6;
+            return qMin(segmentDistance(spline, a, b), segmentDistance(spline, b, c));
+        }
+
+        //
+        // The B-spline through the sections does not pass through them, it cuts
+        // corners (e.g. of the outline) that the chord test between sections
+        // accepts. Splits the intervals next to sections where the spline
+        // deviates more than the tolerance, down to the finest refine depth.
+        //
+        void refineCorners(std::vector<Section> &sections)
+        {
+            qreal minSpacing = qreal(1) / (initialSectionCount << maxRefineDepth);
+            for (int pass = 0; pass < maxRefineDepth; pass++)
+            {
+                std::vector<bool> corner(sections.size(), false);
+                bool any = false;
+                for (size_t i=1; i+1<sections.size(); i++)
+                {
+                    const Section &a = sections[i-1], &b = sections[i], &c = sections[i+1];
+                    if (a.valid && b.valid && c.valid && b.h >= _refinedMin && b.h <= _refinedMax &&
+                        qMax(splineError(a.leadingEdge, b.leadingEdge, c.leadingEdge),
+                             splineError(a.trailingEdge, b.trailingEdge, c.trailingEdge)) > _tolerance * _y_top)
+                        any = corner[i] = true;
+                }
+                if (!any)
+                    return;
+
+                std::vector<Section> split;
+                split.reserve(sections.size() * 2);
+                bool added = false;
+                for (size_t i=0; i<sections.size(); i++)
+                {
+                    split.push_back(sections[i]);
+                    if (i+1 < sections.size() && (corner[i] || corner[i+1]) &&
+                        sections[i+1].h - sections[i].h > 2 * minSpacing)
+                    {
+                        split.push_back(evaluateSection((sections[i].h + sections[i+1].h)/2));
+                        added = true;
+                    }
+                }
+                sections.swap(split);
+                if (!added)
+                    return;
+            }
+        }
+
         void smoothLaplacian(QPointF* pnts[], int firstIndex, int lastIndex, int it_cnt=1)
         {
             for(; it_cnt>0; it_cnt--)
@@ -301,20 +527,14 @@ namespace foillogic
                 t_valStep = (pointCount-1) / qreal(_resolution);
             }
 
-            qreal x, y;
+            // evaluate all points in a single pass over the control points
+            std::vector<qreal> x(_resolution + 1);
+            std::vector<qreal> y(_resolution + 1);
             switch(splineFunction)
             {
             case bSpline:
-                x = hrlib::spline_b_val(pointCount, points_x.data(), t_val);
-                y = hrlib::spline_b_val(pointCount, points_y.data(), t_val);
-                _result->moveTo(x, y);
-                for (size_t i = 1; i <= _resolution; i++)
-                {
-                    t_val += t_valStep;
-                    x = hrlib::spline_b_val(pointCount, points_x.data(), t_val);
-                    y = hrlib::spline_b_val(pointCount, points_y.data(), t_val);
-                    _result->lineTo(x, y);
-                }
+                hrlib::spline_b_val_batch(pointCount, points_x.data(), points_y.data(),
+                                          t_val, t_valStep, x.size(), x.data(), y.data());
                 break;
 
             case overhauser:
@@ -322,18 +542,14 @@ namespace foillogic
                 for (size_t i = 0; i < t_data.size(); i++)
                     t_data[i] = i;
 
-                x = hrlib::spline_overhauser_uni_val(pointCount, t_data.data(), points_x.data(), t_val);
-                y = hrlib::spline_overhauser_uni_val(pointCount, t_data.data(), points_y.data(), t_val);
-                _result->moveTo(x, y);
-                for (size_t i = 1; i <= _resolution; i++)
-                {
-                    t_val += t_valStep;
-                    x = hrlib::spline_overhauser_uni_val(pointCount, t_data.data(), points_x.data(), t_val);
-                    y = hrlib::spline_overhauser_uni_val(pointCount, t_data.data(), points_y.data(), t_val);
-                    _result->lineTo(x, y);
-                }
+                hrlib::spline_overhauser_uni_val_batch(pointCount, t_data.data(), points_x.data(), points_y.data(),
+                                                       t_val, t_valStep, x.size(), x.data(), y.data());
                 break;
             }
+
+            _result->moveTo(x[0], y[0]);
+            for (size_t i = 1; i <= _resolution; i++)
+                _result->lineTo(x[i], y[i]);
         }
     };
 
@@ -0,0 +1,81 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef CONTOURPOLYLINE_HPP
+#define CONTOURPOLYLINE_HPP
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <QPainterPath>
+#include <QPointF>
+#include <QRectF>
+
+namespace foillogic
+{
+    //
+    // Full resolution result of a contour calculation: the points of its
+    // islands as single precision coordinates. A QPainterPath stores an
+    // element type and double coordinates per point, paths are only built
+    // on demand, simplified to the tolerance of the painter they are for.
+    //
+    class ContourPolyline
+    {
+    public:
+        ContourPolyline();
+
+        // Target of ContourCalculator, each moveTo starts an island
+        void moveTo(qreal x, qreal y);
+        void lineTo(qreal x, qreal y);
+        // Releases the capacity reserved for further points
+        void squeeze();
+
+        int pointCount() const;
+        QPointF point(int i) const;
+
+        // Island i spans the points [islandBegin(i), islandEnd(i))
+        int islandCount() const;
+        int islandBegin(int i) const;
+        int islandEnd(int i) const;
+
+        QRectF boundingRect() const;
+        // Size of the point and island buffers [bytes]
+        size_t memoryUsage() const;
+
+        // Path through all points, built once and shared
+        std::shared_ptr<QPainterPath> path() const;
+        // Path deviating at most tolerance from the points (Douglas-Peucker per island)
+        QPainterPath simplified(qreal tolerance) const;
+        // Path of cubic Béziers fitted within tolerance of each island, maxError
+        // receives the largest distance of the points to the curves
+        QPainterPath fitted(qreal tolerance, qreal *maxError = nullptr) const;
+
+    private:
+        std::vector<float> _xy;
+        std::vector<int> _islands; // first point of each island
+
+        mutable std::mutex _pathMutex;
+        mutable std::shared_ptr<QPainterPath> _path;
+    };
+}
+
+#endif // CONTOURPOLYLINE_HPP
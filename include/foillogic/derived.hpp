@@ -0,0 +1,166 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef FOILLOGIC_DERIVED_HPP
+#define FOILLOGIC_DERIVED_HPP
+
+#include <atomic>
+#include <list>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace foillogic
+{
+    //
+    // Hit and miss counts of a derived quantity, shared by all its instances.
+    // Counters register themselves, see DerivedCounter::all().
+    //
+    class DerivedCounter
+    {
+    public:
+        explicit DerivedCounter(const char *name);
+
+        const char *name() const { return _name; }
+        unsigned long long hits() const { return _hits; }
+        unsigned long long misses() const { return _misses; }
+        double hitRate() const;
+
+        void hit() { ++_hits; }
+        void miss() { ++_misses; }
+        void reset();
+
+        static std::vector<DerivedCounter*> all();
+
+    private:
+        const char *_name;
+        std::atomic<unsigned long long> _hits;
+        std::atomic<unsigned long long> _misses;
+    };
+
+    //
+    // Lazily computed value, recomputed only when one of its dependencies
+    // differs from the ones of the cached value. Dependencies are compared
+    // with ==, e.g. Path snapshots or scalar inputs.
+    // Not thread safe, use from the thread owning the foil.
+    //
+    template<typename T, typename... Deps>
+    class Derived
+    {
+    public:
+        explicit Derived(DerivedCounter &counter) : _counter(counter) {}
+
+        // Cached value for deps, nullptr if it has to be computed
+        const T* find(const Deps&... deps)
+        {
+            if (_value && _deps == std::tie(deps...))
+            {
+                _counter.hit();
+                return &*_value;
+            }
+            _counter.miss();
+            return nullptr;
+        }
+
+        const T& store(T value, const Deps&... deps)
+        {
+            _deps = std::tuple<Deps...>(deps...);
+            _value = std::move(value);
+            return *_value;
+        }
+
+        template<typename F>
+        const T& get(F compute, const Deps&... deps)
+        {
+            if (const T* value = find(deps...))
+                return *value;
+            return store(compute(), deps...);
+        }
+
+        void invalidate() { _value.reset(); }
+
+    private:
+        DerivedCounter &_counter;
+        std::tuple<Deps...> _deps;
+        std::optional<T> _value;
+    };
+
+    //
+    // Derived keeping the values of the last capacity dependency sets,
+    // evicting the least recently used one. Lookup is linear, meant for
+    // a few dozen values.
+    //
+    template<typename T, typename... Deps>
+    class DerivedCache
+    {
+    public:
+        DerivedCache(DerivedCounter &counter, size_t capacity) : _counter(counter), _capacity(capacity) {}
+
+        const T* find(const Deps&... deps)
+        {
+            for (auto it = _entries.begin(); it != _entries.end(); ++it)
+                if (it->first == std::tie(deps...))
+                {
+                    _entries.splice(_entries.begin(), _entries, it);
+                    _counter.hit();
+                    return &_entries.front().second;
+                }
+            _counter.miss();
+            return nullptr;
+        }
+
+        // Replaces the value of deps when already cached, e.g. by an overlapping calculation
+        const T& store(T value, const Deps&... deps)
+        {
+            for (auto it = _entries.begin(); it != _entries.end(); ++it)
+                if (it->first == std::tie(deps...))
+                {
+                    it->second = std::move(value);
+                    _entries.splice(_entries.begin(), _entries, it);
+                    return _entries.front().second;
+                }
+            _entries.emplace_front(std::tuple<Deps...>(deps...), std::move(value));
+            if (_entries.size() > _capacity)
+                _entries.pop_back();
+            return _entries.front().second;
+        }
+
+        template<typename F>
+        const T& get(F compute, const Deps&... deps)
+        {
+            if (const T* value = find(deps...))
+                return *value;
+            return store(compute(), deps...);
+        }
+
+        size_t size() const { return _entries.size(); }
+        size_t capacity() const { return _capacity; }
+        void invalidate() { _entries.clear(); }
+
+    private:
+        DerivedCounter &_counter;
+        size_t _capacity;
+        std::list<std::pair<std::tuple<Deps...>, T> > _entries;
+    };
+}
+
+#endif // FOILLOGIC_DERIVED_HPP
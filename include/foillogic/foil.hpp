@@ -33,6 +33,8 @@
 #include "boost/units/systems/si/volume.hpp"
 #include "hrlib/mixin/identifiable.hpp"
 #include "hrlib/mixin/historical.hpp"
+#include "hrlib/mixin/transactional.hpp"
+#include "foillogic/derived.hpp"
 #include "jenson.h"
 
 namespace foillogic
@@ -74,7 +76,7 @@ namespace foillogic
         virtual ~Base() {}
     };
 
-    class Foil : public QObject, public hrlib::Identifiable, public hrlib::THistorical<5>
+    class Foil : public QObject, public hrlib::Identifiable, public hrlib::THistorical<5>, public hrlib::Transactional
     {
         Q_OBJECT
 
@@ -111,6 +113,20 @@ namespace foillogic
         std::unique_ptr<patheditor::IPath> twistSI();
         bool aspectRatioEnforced() const;
 
+        // Immutable copy of the current geometry for background calculations,
+        // unchanged paths are shared with earlier snapshots
+        std::shared_ptr<const FoilGeometry> snapshot();
+
+        // Emits foilReleased, deferred until the end of a running ChangeTransaction.
+        // Within a transaction a pending release supersedes pending changes,
+        // a bulk edit then results in a single foilReleased.
+        void notifyReleased();
+
+        // Outline minY, i.e. minus the outline height in path coordinates
+        qreal outlineTop();
+        // Distance between the tops of the thickness profiles in path coordinates
+        qreal thicknessSpan();
+
 
         boost::units::quantity<boost::units::si::length, qreal> thickness() const;
         void setThickness(boost::units::quantity<boost::units::si::length, qreal> thickness);
@@ -172,6 +188,12 @@ namespace foillogic
 
         boost::units::quantity<boost::units::si::volume, qreal> _volume;
 
+        // Extremes of the paths, derived lazily from their geometry
+        typedef std::shared_ptr<const patheditor::PathSnapshot> Snapshot;
+        Derived<qreal, Snapshot> _outlineTop;
+        Derived<qreal, Snapshot, Snapshot> _thicknessSpan;
+        Derived<qreal, Snapshot> _topProfileMaxY, _botProfileMinY;
+
         void initOutline();
         void initProfile();
         void initThickness();
@@ -180,6 +202,9 @@ namespace foillogic
         void connectProfile();
         void connectThickness();
 
+    protected:
+        virtual void sendNotifications(unsigned flags) override;
+
     private slots:
         void onFoilChanged();
         void onFoilReleased();
@@ -15,21 +15,31 @@
 #define FOILCALCULATOR_HPP
 
 #include "foillogic/fwd/foillogicfwd.hpp"
+#include "patheditor/fwd/patheditorfwd.hpp"
 
 #include <QObject>
-#include <QThreadPool>
+#include <QRunnable>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QRectF>
 #include <memory>
 #include <QPainterPath>
+#include <QMap>
 #include <boost/units/quantity.hpp>
 #include <boost/units/systems/si/area.hpp>
+#include <boost/units/systems/si/plane_angle.hpp>
+#include "foillogic/derived.hpp"
+#include "hrlib/concurrent/scheduler.hpp"
 
 namespace foillogic
 {
+    class AreaSweepCalculator;
+
     class FoilCalculator : public QObject
     {
         Q_OBJECT
     public:
-        explicit FoilCalculator(Foil* foil);
+        explicit FoilCalculator(Foil* foil, std::shared_ptr<ContourCache> cache = nullptr);
 
         Foil* foil();
         void setFoil(Foil* foil);
@@ -37,46 +47,168 @@ namespace foillogic
         QList<qreal> contourThicknesses() const;
         void setContourThicknesses(QList<qreal> thicknesses);
         void setEquidistantContours(int contourCount);
+        qreal contourTolerance() const;
+        void setContourTolerance(qreal tolerance);
+
+        // Release calculations are looked up in and stored to the cache in the background, nullptr disables.
+        // With a view, the full fidelity results are calculated for the cache in the background.
+        std::shared_ptr<ContourCache> contourCache() const;
+        void setContourCache(std::shared_ptr<ContourCache> cache);
+
+        // Full resolution contours, e.g. for export
+        QList<std::shared_ptr<const ContourPolyline> > topPolylines() const;
+        QList<std::shared_ptr<const ContourPolyline> > bottomPolylines() const;
+        // Paths through the full resolution contours, built on first use
         QList<std::shared_ptr<QPainterPath> > topContours();
         QList<std::shared_ptr<QPainterPath> > bottomContours();
-
+        // Contours fitted with cubic Béziers within tolerance, e.g. for vector export,
+        // maxError receives the largest distance of the calculated points to the curves
+        QList<QPainterPath> topCurves(qreal tolerance, qreal *maxError = nullptr) const;
+        QList<QPainterPath> bottomCurves(qreal tolerance, qreal *maxError = nullptr) const;
+        // Non-overlapping bands of the contours, built with the release results in the
+        // background. Null for drag previews, their contours are filled as they are.
+        std::shared_ptr<const ContourBands> topBands() const;
+        std::shared_ptr<const ContourBands> bottomBands() const;
+
+        // Drag updates are calculated at most once per frame interval [ms],
+        // on the geometry at the end of the interval. 0 calculates once per event loop pass.
+        int frameInterval() const;
+        void setFrameInterval(int interval);
+
+        //
+        // Part of the outline shown for side [scene coordinates] and its scale
+        // [device px per scene unit], a null rect clears it. With a view for both
+        // sides, calculations only refine the visible sections and follow the
+        // screen space error. A view needing more detail than the last
+        // calculation recalculates shortly after.
+        //
+        void setView(foillogic::Side::e side, const QRectF &visible, qreal scale);
+
+        //
+        // Calculations run in the background on a snapshot of the foil and
+        // deliver their results with foilCalculated(). Results older than the
+        // delivered ones are dropped.
+        //
         void calculate(bool fastCalc);
+        // Full fidelity contours regardless of the view, e.g. for export
+        void calculateFull();
+        // Blocks until the started calculations delivered their results
+        void wait();
         bool calculated() const;
         void recalculateArea();
 
-        virtual ~FoilCalculator() {}
+        virtual ~FoilCalculator();
 
     signals:
         void foilCalculated(FoilCalculator* sender);
+        // Emitted from the worker threads, delivered queued
+        void calculationFinished(quint64 generation);
 
     public slots:
 
     private:
+        // Tolerance, resolution and refined normalised heights of a calculation
+        struct Detail
+        {
+            qreal tolerance;
+            size_t resolution;
+            qreal hMin;
+            qreal hMax;
+        };
+
         bool _calculated;
-        QThreadPool _tPool;
 
         Foil* _foil;
 
         QList<qreal> _contourThicknesses;
-        QList<std::shared_ptr<QPainterPath> > _topContours;
-        QList<std::shared_ptr<QPainterPath> > _botContours;
-
-        bool inProfileSide(qreal thicknessPercent, foillogic::Side::e side);
+        qreal _contourTolerance;
+        QList<std::shared_ptr<const ContourPolyline> > _topContours;
+        QList<std::shared_ptr<const ContourPolyline> > _botContours;
+        std::shared_ptr<const ContourBands> _topBands;
+        std::shared_ptr<const ContourBands> _botBands;
+
+        std::shared_ptr<ContourCache> _contourCache;
+
+        int _frameInterval;
+        QTimer _frameTimer;
+        QElapsedTimer _lastCalculation;
+
+        QRectF _views[2];
+        qreal _viewScales[2];
+        QTimer _viewTimer;
+        Detail _calculatedDetail;
+
+        // Last area and sweep, by outline, outline height, AR enforced and the profiles when enforced
+        typedef std::shared_ptr<const patheditor::PathSnapshot> Snapshot;
+        Derived<std::shared_ptr<const AreaSweepCalculator>, Snapshot, qreal, bool, Snapshot, Snapshot> _areaSweep;
+
+        // Release contours by outline, thickness, profile, AR enforced, detail, side and specific percentage
+        DerivedCache<std::shared_ptr<const ContourPolyline>, Snapshot, Snapshot, Snapshot, bool, qreal, size_t, qreal, qreal, int, qreal> _levels;
+
+        // Running calculations by generation, the results of a generation
+        // at or below the applied one are stale
+        struct Calculation;
+        QMap<quint64, std::shared_ptr<Calculation> > _running;
+        quint64 _generation;
+        quint64 _appliedGeneration;
+        // Latest release calculation or cache lookup, older lookups are not continued
+        quint64 _requested;
+        // A single drag preview runs at a time
+        bool _previewRunning;
+        bool _previewPending;
+        // Full fidelity results calculated for the contour cache, one at a time
+        bool _filling;
+        hrlib::concurrent::TaskGroup _tasks;
+
+        void calculate(bool fastCalc, bool full);
+        std::shared_ptr<Calculation> plan(std::shared_ptr<const FoilGeometry> geometry, const Detail &detail, bool fastCalc);
+        void start(std::shared_ptr<Calculation> calculation);
+        // Applies the results, or calculates after a cache lookup without them
+        void finish(std::shared_ptr<Calculation> calculation);
+        void apply(Calculation &calculation);
+        bool viewDetail(const FoilGeometry &geometry, bool fastCalc, qreal margin, Detail *detail) const;
+
+        static bool inProfileSide(const FoilGeometry &geometry, qreal thicknessPercent, foillogic::Side::e side);
 
     private slots:
         void foilChanged();
         void foilReleased();
+        void onFrame();
+        void onViewChanged();
+        void onCalculationFinished(quint64 generation);
     };
 
     class AreaSweepCalculator : public QRunnable
     {
     public:
+        // run() reads and updates the foil
         explicit AreaSweepCalculator(Foil* foil);
+        // run() only reads the geometry, see apply()
+        explicit AreaSweepCalculator(std::shared_ptr<const FoilGeometry> geometry);
+        // Results of an earlier run on geometry, e.g. from the contour cache
+        AreaSweepCalculator(std::shared_ptr<const FoilGeometry> geometry,
+                            boost::units::quantity<boost::units::si::area, qreal> area,
+                            boost::units::quantity<boost::units::si::plane_angle, qreal> sweep,
+                            qreal thickness);
 
         virtual void run();
 
+        // Writes the results of the last run to foil
+        void apply(Foil* foil) const;
+
+        boost::units::quantity<boost::units::si::area, qreal> area() const;
+        boost::units::quantity<boost::units::si::plane_angle, qreal> sweep() const;
+        qreal thickness() const;
+
     private:
         Foil* _foil;
+        std::shared_ptr<const FoilGeometry> _geometry;
+
+        boost::units::quantity<boost::units::si::area, qreal> _area;
+        boost::units::quantity<boost::units::si::plane_angle, qreal> _sweep;
+        qreal _thickness;
+
+        void calculate(const FoilGeometry &geometry);
     };
 }
 
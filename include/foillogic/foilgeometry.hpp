@@ -0,0 +1,63 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef FOILGEOMETRY_HPP
+#define FOILGEOMETRY_HPP
+
+#include "foillogic/fwd/foillogicfwd.hpp"
+#include "patheditor/fwd/patheditorfwd.hpp"
+
+#include <memory>
+#include <QPointF>
+#include "foillogic/profile.hpp"
+
+namespace foillogic
+{
+    //
+    // Immutable snapshot of the geometry of a Foil, see Foil::snapshot().
+    // Paths are in the internal coordinates of the editors (y-axis pointing
+    // downwards). Paths that did not change are shared with earlier snapshots.
+    //
+    struct FoilGeometry
+    {
+        std::shared_ptr<const patheditor::PathSnapshot> outline;
+        std::shared_ptr<const patheditor::PathSnapshot> topProfile;
+        std::shared_ptr<const patheditor::PathSnapshot> botProfile;
+        std::shared_ptr<const patheditor::PathSnapshot> topThickness;
+        std::shared_ptr<const patheditor::PathSnapshot> botThickness;
+
+        qreal outlineHeight; // [m]
+        qreal thickness;     // [m]
+
+        Profile::Symmetry symmetry;
+        qreal thicknessRatio;
+        qreal pxThickness;
+        QPointF topProfileTop;
+        QPointF bottomProfileTop;
+        qreal topProfileMaxY;
+        qreal botProfileMinY;
+
+        bool aspectRatioEnforced;
+    };
+}
+
+#endif // FOILGEOMETRY_HPP
@@ -34,6 +34,10 @@ namespace foillogic
     class ThicknessProfile;
     class Foil;
     class FoilCalculator;
+    class ContourCache;
+    class ContourBands;
+    class ContourPolyline;
+    struct FoilGeometry;
 
     struct Side
     {
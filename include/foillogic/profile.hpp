@@ -30,6 +30,7 @@
 #include "boost/units/quantity.hpp"
 #include "boost/units/systems/si/length.hpp"
 #include "hrlib/mixin/identifiable.hpp"
+#include "foillogic/derived.hpp"
 #include "jenson.h"
 
 namespace foillogic
@@ -110,8 +111,12 @@ namespace foillogic
         qshared_ptr<patheditor::Path> _topProfile;
         qunique_ptr<patheditor::Path> _botProfile;
 
-        QPointF _topProfileTop, _botProfileTop;
-        qreal t_topProfileTop, t_botProfileTop;
+        // Tops are derived lazily from the profile geometry, t_*ProfileTop
+        // holds the last top as start value for the next search
+        struct ProfileTop { QPointF point; qreal t; };
+        typedef std::shared_ptr<const patheditor::PathSnapshot> Snapshot;
+        mutable Derived<ProfileTop, Snapshot> _topProfileTop, _botProfileTop;
+        mutable qreal t_topProfileTop, t_botProfileTop;
 
         int _flags;
 
@@ -35,17 +35,51 @@
 
 namespace foillogic
 {
+    //
+    // Collects sorted sample streams and merges them once into a single
+    // sorted sequence, dropping samples closer than tolerance to their predecessor.
+    //
     class FeatureSampler
     {
-      std::vector<qreal> _featureSamples;
+      qreal _tolerance;
+      std::vector<std::vector<qreal>> _streams;
+      std::vector<qreal> _samples;
+      bool _merged;
+
+      void merge();
 
     public:
-      FeatureSampler();
+      explicit FeatureSampler(qreal tolerance = 1e-9);
       void addFeatureSamples(const patheditor::IPath *path, std::function<qreal(QPointF)> getter, size_t sample_rate);
       void addUniformSamples(double min, double max, size_t cnt);
+      const std::vector<qreal> &samples();
       std::vector<qreal> sampleAt(size_t resolution);
     };
 
+    //
+    // Thickness (y) of a thickness profile at a height (x), found by inverting
+    // the x polynomial of the profile segments in closed form.
+    // The profile must be monotone in x.
+    //
+    class ThicknessLookup
+    {
+      struct Segment
+      {
+        qreal xEnd;
+        qreal x[4]; // power basis coefficients of t^0 .. t^3
+        qreal y[4];
+      };
+      std::vector<Segment> _segments;
+
+      static qreal thicknessAt(const Segment &segment, qreal height);
+
+    public:
+      explicit ThicknessLookup(const patheditor::IPath *thicknessProfile);
+      qreal thicknessAt(qreal height) const;
+      // Single walk over the segments, the heights must be sorted
+      std::vector<qreal> sample(const std::vector<qreal> &sortedHeights) const;
+    };
+
   std::vector<qreal> sampleThickess(const patheditor::IPath *thicknessProfile, const std::vector<qreal> &sectionHeightArray);
 }
 
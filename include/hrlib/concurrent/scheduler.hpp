@@ -0,0 +1,139 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef HRLIB_SCHEDULER_HPP
+#define HRLIB_SCHEDULER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hrlib
+{
+namespace concurrent
+{
+    // Lanes are served in order, a queued Interactive task always runs
+    // before any queued Release or Background task
+    struct Priority { enum e { Interactive = 0, Release = 1, Background = 2 }; };
+
+    class TaskGroup;
+
+    //
+    // Work-stealing task scheduler.
+    // Each worker keeps its own deque per priority lane: tasks submitted by a
+    // worker go to its own deque and are run newest first, idle workers steal
+    // the oldest tasks of the others. Tasks submitted from other threads go to
+    // a shared injection queue.
+    //
+    class Scheduler
+    {
+    public:
+        typedef std::function<void()> Task;
+
+        // threadCount 0 uses the number of hardware threads
+        explicit Scheduler(unsigned threadCount = 0);
+
+        // Process-wide scheduler, the HRLIB_THREADS environment variable
+        // overrides its thread count
+        static Scheduler& instance();
+
+        unsigned threadCount() const;
+        void submit(Task task, Priority::e priority = Priority::Release, TaskGroup *group = nullptr);
+
+        // Runs queued tasks until all are done, then joins the workers
+        virtual ~Scheduler();
+
+    private:
+        static const int laneCount = 3;
+
+        struct Entry
+        {
+            Task task;
+            TaskGroup *group;
+        };
+
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Entry> lanes[laneCount];
+        };
+
+        // _queues[0] is the injection queue, _queues[i] belongs to worker i
+        std::vector<std::unique_ptr<Queue>> _queues;
+        std::vector<std::thread> _workers;
+
+        std::mutex _sleepMutex;
+        std::condition_variable _wake;
+        std::atomic<int> _queued;
+        std::atomic<bool> _stop;
+
+        size_t currentQueue() const;
+        bool pop(Queue &queue, int lane, bool newest, Entry &entry);
+        bool runOne(size_t self, int maxLane);
+        void workerLoop(size_t self);
+
+        friend class TaskGroup;
+    };
+
+    //
+    // Tracks a set of tasks. Waiting helps running queued tasks of the same
+    // or higher priority as the queued tasks of the group, so waiting from
+    // within a task does not deadlock. Without queued tasks it sleeps until
+    // the running ones finish.
+    //
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(Scheduler &scheduler = Scheduler::instance());
+
+        void run(Scheduler::Task task, Priority::e priority = Priority::Release);
+        void wait();
+
+        // Waits for the remaining tasks
+        virtual ~TaskGroup();
+
+    private:
+        Scheduler &_scheduler;
+        std::atomic<int> _pending;
+        // Tasks of the group queued but not started, per lane
+        std::atomic<int> _queued[Scheduler::laneCount];
+
+        std::mutex _mutex;
+        std::condition_variable _changed;
+
+        // Lowest priority lane with queued tasks of the group, -1 if none
+        int queuedLane() const;
+        void submitted();
+        void started(int lane);
+        void finished();
+
+        friend class Scheduler;
+    };
+}
+}
+
+#endif // HRLIB_SCHEDULER_HPP
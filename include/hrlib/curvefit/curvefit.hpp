@@ -26,6 +26,8 @@
 #include <vector>
 #include <array>
 #include <cmath>
+#include <cstdlib>
+#include <algorithm>
 #include <boost/math/special_functions/pow.hpp>
 #include <boost/utility/value_init.hpp>
 
@@ -66,6 +68,76 @@ namespace hrlib {
 
       return handles;
     }
+
+    //
+    // Fits a minimal piecewise cubic Bézier within error of points.
+    // Returns per knot { left handle, knot, right handle }, the segment
+    // from knot i to i+1 is { knot_i, right handle_i, left handle_i+1, knot_i+1 }.
+    // maxError receives the largest distance of points to the fitted curve.
+    //
+    static std::vector<std::array<vertex<Dim>,3>>
+    cubic(const std::vector<vertex<Dim>> &points, double error, double *maxError = nullptr)
+    {
+      std::vector<std::array<vertex<Dim>,3>> knots;
+      if (maxError)
+        *maxError = 0;
+      if (points.size() < 2)
+        return knots;
+
+      double *cubics = nullptr;
+      unsigned int cubicsLen = 0;
+      unsigned int *origIndex = nullptr;
+      if (curve_fit_cubic_to_points_db((const double*)points.data(), points.size(), Dim, error,
+                                       CURVE_FIT_CALC_HIGH_QUALIY, nullptr, 0,
+                                       &cubics, &cubicsLen, &origIndex, nullptr, nullptr) != 0)
+        return knots;
+
+      knots.resize(cubicsLen);
+      for (unsigned int i=0; i<cubicsLen; i++)
+        for (int j=0; j<3; j++)
+          std::copy(cubics + (3*i + j)*Dim, cubics + (3*i + j + 1)*Dim, knots[i][j].begin());
+
+      // Distance of the points fitted by each segment to the segment, sampled as a polyline
+      if (maxError && origIndex)
+      {
+        const int samples = 32;
+        std::vector<vertex<Dim>> curve(samples + 1);
+        for (unsigned int k=0; k+1<cubicsLen; k++)
+        {
+          const vertex<Dim> &p0 = knots[k][1], &p1 = knots[k][2], &p2 = knots[k+1][0], &p3 = knots[k+1][1];
+          for (int s=0; s<=samples; s++)
+          {
+            double t = double(s) / samples, u = 1 - t;
+            for (int d=0; d<Dim; d++)
+              curve[s][d] = u*u*u*p0[d] + 3*u*u*t*p1[d] + 3*u*t*t*p2[d] + t*t*t*p3[d];
+          }
+
+          for (unsigned int i=origIndex[k]; i<=origIndex[k+1] && i<points.size(); i++)
+          {
+            double minSq = HUGE_VAL;
+            for (int s=0; s<samples; s++)
+            {
+              double ab = 0, ap = 0;
+              for (int d=0; d<Dim; d++)
+              {
+                ab += boost::math::pow<2>(curve[s+1][d] - curve[s][d]);
+                ap += (points[i][d] - curve[s][d]) * (curve[s+1][d] - curve[s][d]);
+              }
+              double t = ab > 0 ? std::min(1.0, std::max(0.0, ap / ab)) : 0;
+              double distSq = 0;
+              for (int d=0; d<Dim; d++)
+                distSq += boost::math::pow<2>(points[i][d] - curve[s][d] - t * (curve[s+1][d] - curve[s][d]));
+              minSq = std::min(minSq, distSq);
+            }
+            *maxError = std::max(*maxError, std::sqrt(minSq));
+          }
+        }
+      }
+
+      std::free(cubics);
+      std::free(origIndex);
+      return knots;
+    }
   };
 }
 
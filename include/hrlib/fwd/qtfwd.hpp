@@ -50,6 +50,7 @@ class QFile;
 class QRectF;
 class QPainter;
 class QImage;
+class QBrush;
 
 QT_END_NAMESPACE
 
@@ -0,0 +1,167 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef HRLIB_INSTRUMENT_HPP
+#define HRLIB_INSTRUMENT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace hrlib
+{
+namespace instrument
+{
+  // Probes are always compiled in and switched at runtime,
+  // a disabled probe costs a relaxed atomic load
+  bool enabled();
+  void setEnabled(bool enabled);
+
+  // Tracing records every zone and counter change with its thread
+  // in per-thread buffers, independent of the Timer statistics.
+  // startTracing() discards the events of a previous trace.
+  bool tracing();
+  void startTracing();
+  void stopTracing();
+
+  // Writes the recorded trace as Chrome trace-event JSON,
+  // viewable in chrome://tracing or ui.perfetto.dev
+  bool writeChromeTrace(std::ostream &out);
+
+  // Small sequential id of the calling thread, as used in traces
+  uint32_t threadId();
+
+  // Appends to the calling thread's trace buffer [ns]
+  void traceZone(const char *name, int64_t start, int64_t end);
+  void traceCounter(const char *name, int64_t value);
+
+  // Monotonic clock [ns]
+  inline int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  //
+  // Durations of one instrumented stage, recorded from any thread.
+  // Define a static Timer per stage and time scopes with a Zone.
+  // Timers register themselves, see Timer::all().
+  //
+  class Timer
+  {
+  public:
+    explicit Timer(const char *name);
+
+    struct Stats
+    {
+      uint64_t count;
+      int64_t total; // [ns]
+      int64_t max;   // [ns]
+    };
+
+    const char *name() const { return _name; }
+    void record(int64_t ns);
+
+    Stats stats() const;
+    // Stats since the previous take(), resets them
+    Stats take();
+
+    static std::vector<Timer*> all();
+
+  private:
+    const char *_name;
+    std::atomic<uint64_t> _count;
+    std::atomic<int64_t> _total;
+    std::atomic<int64_t> _max;
+  };
+
+  //
+  // A named value traced over time, e.g. a queue length or item count.
+  // Define counters statically like Timers.
+  //
+  class Counter
+  {
+  public:
+    explicit Counter(const char *name);
+
+    const char *name() const { return _name; }
+    int64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+    void set(int64_t value)
+    {
+      _value.store(value, std::memory_order_relaxed);
+      if (tracing())
+        traceCounter(_name, value);
+    }
+
+    void add(int64_t delta)
+    {
+      int64_t value = _value.fetch_add(delta, std::memory_order_relaxed) + delta;
+      if (tracing())
+        traceCounter(_name, value);
+    }
+
+    static std::vector<Counter*> all();
+
+  private:
+    const char *_name;
+    std::atomic<int64_t> _value;
+  };
+
+  //
+  // Records the lifetime of the scope in a Timer and the trace,
+  // when enabled or tracing
+  //
+  class Zone
+  {
+  public:
+    explicit Zone(Timer &timer) :
+      _timer(enabled() || tracing() ? &timer : nullptr), _start(_timer ? now() : 0) {}
+    ~Zone() { end(); }
+
+    // Records now instead of at the end of the scope
+    void end()
+    {
+      if (_timer)
+      {
+        int64_t end = now();
+        if (enabled())
+          _timer->record(end - _start);
+        if (tracing())
+          traceZone(_timer->name(), _start, end);
+      }
+      _timer = nullptr;
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+  private:
+    Timer *_timer;
+    int64_t _start;
+  };
+}
+}
+
+#endif // HRLIB_INSTRUMENT_HPP
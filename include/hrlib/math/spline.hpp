@@ -12,9 +12,21 @@
 
 namespace hrlib {
 
-qreal basis_function_b_val ( qreal tdata[], qreal tval );
+//
+//  Interval of the last R8VEC_BRACKET search, kept by the caller across
+//  evaluations on the same knot vector.  LEFT = 0 means no search yet.
+//
+struct r8vec_bracket_cursor
+{
+  int left;
+
+  r8vec_bracket_cursor ( ) : left ( 0 ) { }
+};
+
+qreal basis_function_b_val ( qreal tdata[], qreal tval,
+  r8vec_bracket_cursor *cursor = 0 );
 qreal basis_function_beta_val ( qreal beta1, qreal beta2, qreal tdata[],
-  qreal tval );
+  qreal tval, r8vec_bracket_cursor *cursor = 0 );
 qreal *basis_matrix_b_uni ( );
 qreal *basis_matrix_beta_uni ( qreal beta1, qreal beta2 );
 qreal *basis_matrix_bezier ( );
@@ -58,6 +70,9 @@ void parabola_val2 ( int ndim, int ndata, qreal tdata[], qreal ydata[],
   int left, qreal tval, qreal yval[] );
 qreal pchst ( qreal arg1, qreal arg2 );
 qreal r8_uniform_01 ( int *seed );
+void r8vec_bracket ( int n, qreal x[], qreal xval, int *left, int *right );
+void r8vec_bracket ( int n, qreal x[], qreal xval, int *left, int *right,
+  r8vec_bracket_cursor *cursor );
 void r8vec_bracket3 ( int n, qreal t[], qreal tval, int *left );
 qreal *r8vec_even_new ( int n, qreal alo, qreal ahi );
 qreal *r8vec_indicator_new ( int n );
@@ -67,38 +82,44 @@ void r8vec_sort_bubble_a ( int n, qreal a[] );
 qreal *r8vec_uniform_new ( int n, qreal b, qreal c, int *seed );
 int r8vec_unique_count ( int n, qreal a[], qreal tol );
 void r8vec_zero ( int n, qreal a[] );
-qreal spline_b_val ( int ndata, qreal tdata[], qreal ydata[], qreal tval );
+qreal spline_b_val ( int ndata, qreal tdata[], qreal ydata[], qreal tval,
+  r8vec_bracket_cursor *cursor = 0 );
 qreal spline_b_val ( int ndata, qreal ydata[], qreal tval );
+void spline_b_val_batch ( int ndata, qreal xdata[], qreal ydata[],
+  qreal tstart, qreal tstep, int nval, qreal xval[], qreal yval[] );
 qreal spline_beta_val ( qreal beta1, qreal beta2, int ndata, qreal tdata[],
-  qreal ydata[], qreal tval );
-qreal spline_constant_val ( int ndata, qreal tdata[], qreal ydata[], qreal tval );
+  qreal ydata[], qreal tval, r8vec_bracket_cursor *cursor = 0 );
+qreal spline_constant_val ( int ndata, qreal tdata[], qreal ydata[], qreal tval,
+  r8vec_bracket_cursor *cursor = 0 );
 qreal *spline_cubic_set ( int n, qreal t[], qreal y[], int ibcbeg, qreal ybcbeg,
   int ibcend, qreal ybcend );
 qreal spline_cubic_val ( int n, qreal t[], qreal y[], qreal ypp[],
-  qreal tval, qreal *ypval, qreal *yppval );
+  qreal tval, qreal *ypval, qreal *yppval, r8vec_bracket_cursor *cursor = 0 );
 void spline_cubic_val2 ( int n, qreal t[], qreal tval, int *left, qreal y[],
   qreal ypp[], qreal *yval, qreal *ypval, qreal *yppval );
 qreal *spline_hermite_set ( int ndata, qreal tdata[], qreal ydata[],
   qreal ypdata[] );
 void spline_hermite_val ( int ndata, qreal tdata[], qreal c[], qreal tval,
-  qreal *sval, qreal *spval );
+  qreal *sval, qreal *spval, r8vec_bracket_cursor *cursor = 0 );
 qreal spline_linear_int ( int ndata, qreal tdata[], qreal ydata[], qreal a,
-  qreal b );
+  qreal b, r8vec_bracket_cursor *cursor = 0 );
 void spline_linear_intset ( int int_n, qreal int_x[], qreal int_v[],
   qreal data_x[], qreal data_y[] );
 void spline_linear_val ( int ndata, qreal tdata[], qreal ydata[],
-  qreal tval, qreal *yval, qreal *ypval );
+  qreal tval, qreal *yval, qreal *ypval, r8vec_bracket_cursor *cursor = 0 );
 qreal spline_overhauser_nonuni_val ( int ndata, qreal tdata[],
-  qreal ydata[], qreal tval );
+  qreal ydata[], qreal tval, r8vec_bracket_cursor *cursor = 0 );
 qreal spline_overhauser_uni_val ( int ndata, qreal tdata[], qreal ydata[],
-  qreal tval );
+  qreal tval, r8vec_bracket_cursor *cursor = 0 );
+void spline_overhauser_uni_val_batch ( int ndata, qreal tdata[], qreal xdata[],
+  qreal ydata[], qreal tstart, qreal tstep, int nval, qreal xval[], qreal yval[] );
 void spline_overhauser_val ( int ndim, int ndata, qreal tdata[], qreal ydata[],
-  qreal tval, qreal yval[] );
+  qreal tval, qreal yval[], r8vec_bracket_cursor *cursor = 0 );
 void spline_pchip_set ( int n, qreal x[], qreal f[], qreal d[] );
 void spline_pchip_val ( int n, qreal x[], qreal f[], qreal d[], int ne,
   qreal xe[], qreal fe[] );
 void spline_quadratic_val ( int ndata, qreal tdata[], qreal ydata[],
-  qreal tval, qreal *yval, qreal *ypval );
+  qreal tval, qreal *yval, qreal *ypval, r8vec_bracket_cursor *cursor = 0 );
 
 }
 
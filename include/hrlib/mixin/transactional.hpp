@@ -0,0 +1,79 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef HRLIB_TRANSACTIONAL_HPP
+#define HRLIB_TRANSACTIONAL_HPP
+
+namespace hrlib
+{
+    //
+    // Defers change notifications while a ChangeTransaction is open. Each
+    // pending notification is sent once when the outermost transaction ends.
+    //
+    class Transactional
+    {
+    private:
+        int _transactionDepth = 0;
+        unsigned _pending = 0;
+
+    public:
+        class ChangeTransaction
+        {
+        private:
+            Transactional *_target;
+
+        public:
+            explicit ChangeTransaction(Transactional *target) : _target(target) { _target->_transactionDepth++; }
+
+            ~ChangeTransaction()
+            {
+                if (--_target->_transactionDepth == 0 && _target->_pending)
+                {
+                    unsigned pending = _target->_pending;
+                    _target->_pending = 0;
+                    _target->sendNotifications(pending);
+                }
+            }
+
+            ChangeTransaction(const ChangeTransaction&) = delete;
+            ChangeTransaction& operator=(const ChangeTransaction&) = delete;
+        };
+
+        bool inTransaction() const { return _transactionDepth > 0; }
+
+        virtual ~Transactional() {}
+
+    protected:
+        // Sends the notifications in flags now, or when the transaction ends
+        void notify(unsigned flags)
+        {
+            if (inTransaction())
+                _pending |= flags;
+            else
+                sendNotifications(flags);
+        }
+
+        virtual void sendNotifications(unsigned flags) = 0;
+    };
+}
+
+#endif // HRLIB_TRANSACTIONAL_HPP
@@ -36,6 +36,9 @@ namespace patheditor
 
         virtual void createPointHandleImpl(QGraphicsItem *parent, const PathSettings *settings) override;
 
+        virtual const QBrush &handleBrush(const PathSettings *settings) const override;
+        virtual qreal handleZValue() const override { return 2; }
+
         virtual ~ControlPoint() {}
     };
 }
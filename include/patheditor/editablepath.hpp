@@ -25,7 +25,9 @@
 
 #include "patheditor/fwd/patheditorfwd.hpp"
 
+#include <memory>
 #include <QGraphicsObject>
+#include <QHash>
 #include "patheditor/pathsettings.hpp"
 
 namespace patheditor
@@ -53,7 +55,19 @@ namespace patheditor
         void setEditable(bool editable);
         bool editable();
 
-        virtual ~EditablePath() {}
+        /**
+         * @brief syncHandles Attaches point handles to the editable points near visible,
+         *                    released handles are pooled for reuse
+         * @param visible Visible part of the path in item coordinates, null for all points
+         */
+        void syncHandles(const QRectF &visible = QRectF());
+        const PointHandlePool *handlePool() const;
+
+        virtual ~EditablePath();
+
+    public slots:
+        // Repaints the path after its points were moved without dragging, e.g. mirrored
+        void updateExtent();
 
     signals:
         void pathChanged(EditablePath *sender);
@@ -77,7 +91,24 @@ namespace patheditor
         Path* _path = 0;
         const PathSettings* _settings = 0;
 
+        // Extents at the last update, to repaint only what a point drag moved
+        QRectF _boundingRect;
+        QHash<const PathItem*, QRectF> _itemRects;
+
+        // Point handles are only created for editable points around the viewport
+        struct Attached
+        {
+            std::weak_ptr<PathPoint> point;
+            PointHandle *handle;
+        };
+        std::unique_ptr<PointHandlePool> _handles;
+        QHash<PathPoint*, Attached> _attached;
+        QRectF _handleRegion;
+        bool _handlesValid = false;
+        bool _handlesPending = false;
+
         void connectPoints(PathItem *pathItem);
+        void updateAround(PathPoint *point);
         void emitPathChanged();
         void emitPathReleased();
     };
@@ -42,7 +42,9 @@ namespace patheditor
     class PathItem;
     class PathPoint;
     class PathSettings;
+    class PathSnapshot;
     class PointHandle;
+    class PointHandlePool;
     class PointRestrictor;
     class QuadrantRestrictor;
     class Restrictor;
@@ -30,10 +30,11 @@
 #include <memory>
 #include "jenson.h"
 #include "patheditor/ipath.hpp"
+#include "hrlib/mixin/transactional.hpp"
 
 namespace patheditor
 {
-    class Path : public QObject, public IPath
+    class Path : public QObject, public IPath, public hrlib::Transactional
     {
         Q_OBJECT
 
@@ -51,6 +52,7 @@ namespace patheditor
 
         // TODO unittest methods below
 
+        // Cached until a point moves or an item is appended
         QRectF controlPointRect() const;
 
         virtual QPointF pointAtPercent(qreal t) const override;
@@ -63,6 +65,13 @@ namespace patheditor
 
         virtual std::vector<std::vector<QPointF>> bezierItems() const override;
 
+        /**
+         * @brief snapshot Immutable copy of the current geometry, safe to read from worker threads.
+         * Returns the previous snapshot while the geometry is unchanged.
+         * Call from the thread owning the path.
+         */
+        std::shared_ptr<const PathSnapshot> snapshot() const;
+
         void paint(QPainter *painter, bool editable = false, const PathSettings *settings = 0);
 
         void disconnectAll();
@@ -75,11 +84,21 @@ namespace patheditor
         void pathReleased(patheditor::Path *sender);
 
     public slots:
+        // Deferred until the end of a running ChangeTransaction
         void onPathChanged();
         void onPathReleased();
 
+    protected:
+        virtual void sendNotifications(unsigned flags) override;
+
     private:
         QList<std::shared_ptr<PathItem> > _pathItemList;
+        mutable std::shared_ptr<const PathSnapshot> _snapshot;
+        mutable quint64 _snapshotMoves;
+
+        mutable QRectF _controlPointRect;
+        mutable quint64 _controlPointRectMoves;
+        mutable bool _controlPointRectValid;
     };
 }
 
@@ -25,6 +25,7 @@
 
 #include "patheditor/fwd/patheditorfwd.hpp"
 
+#include <cstdint>
 #include <QGraphicsView>
 
 namespace patheditor
@@ -36,13 +37,26 @@ namespace patheditor
 
         void setPixelsPerUnit(qreal pxPerUnit);
 
+        // Part of the scene shown in the viewport
+        QRectF visibleSceneRect() const;
+        // Device pixels per scene unit
+        qreal sceneScale() const;
+
         void setImage(const QUrl &url);
         void setImage(const QString &path);
 
-        virtual ~PathEditorView() {}
+        // Overlay of the paint and calculation timings on all views,
+        // showing it enables the hrlib instrumentation
+        static void setHudVisible(bool visible);
+        static bool hudVisible();
+
+        virtual ~PathEditorView();
 
     protected:
         virtual void drawBackground(QPainter *painter, const QRectF &rect);
+        virtual void drawForeground(QPainter *painter, const QRectF &rect);
+        virtual bool viewportEvent(QEvent *event);
+        virtual void paintEvent(QPaintEvent *event);
         virtual void dragMoveEvent(QDragMoveEvent *event);
         virtual void dropEvent(QDropEvent *event);
         virtual void wheelEvent(QWheelEvent *event);
@@ -51,6 +65,9 @@ namespace patheditor
         qreal _pxPerUnit;
         ScalableImage* _imageItem;
 
+        // Time of the first input event changing the view not painted yet, 0 if none
+        int64_t _inputTime;
+
         void drawLinesWithInterval(qreal px, QPainter *painter, const QRectF &rect);
     };
 }
@@ -43,6 +43,9 @@ namespace patheditor
 
         void setPos(qreal xpos, qreal ypos);
 
+        // Number of point moves up to now, unchanged while no point moved
+        static quint64 moveCount();
+
         void setRestrictedX(qreal xpos);
         void setRestrictedY(qreal ypos);
         void setRestrictedPos(qreal xpos, qreal ypos);
@@ -73,6 +76,16 @@ namespace patheditor
 
         PointHandle *handle();
 
+        /**
+         * Shows handle for this point without taking ownership, e.g. a handle
+         * of a PointHandlePool. nullptr detaches the current handle.
+         */
+        void attachHandle(PointHandle *handle);
+
+        // Appearance of the handles of this point type
+        virtual const QBrush &handleBrush(const PathSettings *settings) const;
+        virtual qreal handleZValue() const { return 1; }
+
         virtual bool continuous() const { return false; }
         virtual void setContinuous(bool /*continuous*/) {}
         virtual void remove() { emit pointRemove(this); }
@@ -110,6 +123,7 @@ namespace patheditor
         QList<std::weak_ptr<PathPoint> > _followingPoints;
 
         PointHandle *_pointHandle = 0;
+        bool _ownsHandle = false;
 
     };
 }
@@ -0,0 +1,71 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef PATHSNAPSHOT_HPP
+#define PATHSNAPSHOT_HPP
+
+#include "hrlib/fwd/qtfwd.hpp"
+#include "patheditor/fwd/patheditorfwd.hpp"
+
+#include <memory>
+#include <vector>
+#include <QPointF>
+#include "patheditor/ipath.hpp"
+
+namespace patheditor
+{
+    //
+    // Immutable copy of the geometry of a Path, see Path::snapshot().
+    // All methods are const and do not touch the originating Path, so a
+    // snapshot can be read from any thread while the Path is being edited.
+    //
+    class PathSnapshot : public IPath
+    {
+    public:
+        // bezierItems: points of each path item, start point, control points and end point
+        explicit PathSnapshot(std::vector<std::vector<QPointF>> bezierItems);
+
+        // Snapshot with all points scaled, e.g. to flip the y-axis
+        std::shared_ptr<const PathSnapshot> scaled(qreal sx, qreal sy) const;
+
+        bool sameGeometry(const std::vector<std::vector<QPointF>> &bezierItems) const;
+
+        virtual QPointF pointAtPercent(qreal t) const override;
+        virtual qreal angleAtPercent(qreal t) const override;
+
+        virtual qreal minX(qreal *t_top = 0) const override;
+        virtual qreal maxX(qreal *t_top = 0) const override;
+        virtual qreal minY(qreal *t_top = 0) const override;
+        virtual qreal maxY(qreal *t_top = 0) const override;
+
+        virtual std::vector<std::vector<QPointF>> bezierItems() const override;
+
+        virtual ~PathSnapshot() {}
+
+    private:
+        const std::vector<std::vector<QPointF>> _items;
+
+        const std::vector<QPointF> &itemAtPercent(qreal *t) const;
+    };
+}
+
+#endif // PATHSNAPSHOT_HPP
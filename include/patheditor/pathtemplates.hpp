@@ -32,7 +32,7 @@
 namespace patheditor
 {
     template <int Dimension, int Multiplier>
-    static qreal extreme(const Path *self, qreal *t_ext)
+    static qreal extreme(const IPath *self, qreal *t_ext)
     {
         std::unique_ptr<f_ValueAtPercentPath<Dimension,Multiplier>> target(new f_ValueAtPercentPath<Dimension,Multiplier>(self));
 
@@ -40,6 +40,10 @@ namespace patheditor
                              const PathSettings *settings,
                              QGraphicsItem *parent = 0);
 
+        PathPoint *point();
+        // Moves the handle to another point, e.g. when reused by a PointHandlePool
+        void setPoint(PathPoint *point);
+
         void setCenter(QPointF *point);
         void setCenter(qreal &xpos, qreal &ypos);
 
@@ -0,0 +1,63 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#ifndef POINTHANDLEPOOL_HPP
+#define POINTHANDLEPOOL_HPP
+
+#include "hrlib/fwd/qtfwd.hpp"
+#include "patheditor/fwd/patheditorfwd.hpp"
+
+#include <QList>
+
+namespace patheditor
+{
+    /**
+     * @brief Reusable PointHandles, children of a common parent item
+     */
+    class PointHandlePool
+    {
+    public:
+        explicit PointHandlePool(QGraphicsItem *parent, const PathSettings *settings);
+
+        /**
+         * @brief acquire Attaches a free handle to point, creating one when none is free
+         */
+        PointHandle *acquire(PathPoint *point);
+
+        /**
+         * @brief release Hides handle, it is reused by the next acquire()
+         * @param detach false when the point of the handle no longer exists
+         */
+        void release(PointHandle *handle, bool detach = true);
+
+        int created() const;
+        int inUse() const;
+
+    private:
+        QGraphicsItem *_parent;
+        const PathSettings *_settings;
+        QList<PointHandle*> _free;
+        int _created;
+    };
+}
+
+#endif // POINTHANDLEPOOL_HPP
@@ -26,14 +26,23 @@
 #include "patheditor/fwd/patheditorfwd.hpp"
 
 #include <QGraphicsObject>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
 #include <memory>
 
 namespace patheditor
 {
+    /**
+     * @brief A background image, scaled by dragging its top right corner.
+     * Paints a mip level or a copy scaled to the device pixels it covers,
+     * both generated off the GUI thread, instead of rescaling the full image.
+     */
     class ScalableImage : public QGraphicsObject
     {
         Q_OBJECT
     public:
+        explicit ScalableImage(const QImage &image, const QRect &initialRect, QGraphicsItem *parent = 0);
         explicit ScalableImage(const QPixmap &pixmap, const QRect &initialRect, QGraphicsItem *parent = 0);
 
         virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
@@ -42,16 +51,43 @@ namespace patheditor
         virtual ~ScalableImage();
 
     signals:
+        // Emitted from the worker threads, delivered queued
+        void mipReady(int level, QImage image);
+        void scaledReady(QImage image);
 
     public slots:
 
     private:
-        QPixmap _pixmap;
+        QImage _image;
         QRect _rect;
         std::unique_ptr<ScalePoint> _scalePoint;
+        bool _dragging;
+
+        // _mips[0] is the image itself, each next level halves it.
+        // Only the reduced levels are converted to pixmaps.
+        QList<QImage> _mips;
+        QHash<int, QPixmap> _mipPixmaps;
+        int _mipsPending;
+        // Nearest neighbour reduction, or the image itself when it has no mip levels
+        QPixmap _preview;
+
+        // The image scaled to the device pixels it covered at the last paint
+        QPixmap _scaled;
+        QSize _wantedSize;
+        bool _scaling;
+
+        // Shared with the scaling jobs, which may outlive the image
+        struct Jobs;
+        std::shared_ptr<Jobs> _jobs;
+
+        const QPixmap &mipPixmap(const QSize &target);
+        void requestScaled(const QSize &size);
 
     private slots:
         void onScaleMove(PathPoint *point);
+        void onScaleRelease(PathPoint *point);
+        void onMipReady(int level, QImage image);
+        void onScaledReady(QImage image);
     };
 }
 
@@ -34,6 +34,8 @@ namespace patheditor
 
         virtual void createPointHandleImpl(QGraphicsItem *parent, const PathSettings *settings) override;
 
+        virtual const QBrush &handleBrush(const PathSettings *settings) const override;
+
         virtual ~ScalePoint() {}
     };
 }
@@ -62,6 +62,11 @@ int main(int argc, char *argv[])
         parser.addOption(serverUrl);
 #endif
 
+        QCommandLineOption traceFile(QStringLiteral("trace"),
+                                     QApplication::tr("Record a Chrome trace-event timeline to FILE until finFoil quits."),
+                                     QStringLiteral("FILE"));
+        parser.addOption(traceFile);
+
         parser.addPositionalArgument(QStringLiteral("file"), QApplication::tr("File to open."));
 
         // Process the actual command line arguments given by the user
@@ -81,7 +86,7 @@ int main(int argc, char *argv[])
         if (!baseUrl.isValid())
             baseUrl = QUrl("http://finfoil.io/s"); // https is hard to support in qwebengine on windows :(
 
-        return runInteractive(app, baseUrl, filePath);
+        return runInteractive(app, baseUrl, filePath, parser.value(traceFile));
     }
     catch (std::exception &ex)
     {
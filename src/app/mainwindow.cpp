@@ -31,6 +31,7 @@
 #include <QTextStream>
 #include <QJsonDocument>
 #include <QCloseEvent>
+#include <sstream>
 #include "app/main.hpp"
 #include "foileditors/foileditors.hpp"
 #include "jenson.h"
@@ -41,6 +42,8 @@
 #include "foillogic/foilio.hpp"
 #include "foillogic/thicknessprofile.hpp"
 #include "hrlib/string/json_utils.hpp"
+#include "hrlib/instrument/instrument.hpp"
+#include "patheditor/patheditorview.hpp"
 
 #ifndef WEB_DISABLED
 #include "web/exportdialog.hpp"
@@ -50,6 +53,21 @@ using namespace foileditors;
 using namespace foillogic;
 using namespace jenson;
 
+namespace {
+    // File load and save stages, see hrlib::instrument
+    hrlib::instrument::Timer s_readJsonTimer("MainWindow::readJson");
+    hrlib::instrument::Timer s_writeJsonTimer("MainWindow::writeJson");
+    hrlib::instrument::Timer s_deserializeTimer("JenSON::deserialize");
+    hrlib::instrument::Timer s_serializeTimer("JenSON::serialize");
+
+    template<typename T>
+    auto deserializeJson(QJsonObject *jObj, QString *errorMsg)
+    {
+        hrlib::instrument::Zone zone(s_deserializeTimer);
+        return JenSON::deserialize<T>(jObj, errorMsg);
+    }
+}
+
 MainWindow::MainWindow(const QUrl &baseUrl, const hrlib::Version version, QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::MainWindow),
@@ -76,6 +94,8 @@ void MainWindow::closeEvent(QCloseEvent *event)
     if (maybeSave())
     {
         // TODO store settings
+        if (recordTraceAct->isChecked())
+            recordTraceAct->setChecked(false);
         event->accept();
     }
     else
@@ -171,7 +191,7 @@ void MainWindow::loadOutline()
     QString errorMsg;
     QJsonObject jObj;
     if (!loadFileToJson(filePath, jObj)) return;
-    auto deserialized = JenSON::deserialize<Outline>(&jObj, &errorMsg);
+    auto deserialized = deserializeJson<Outline>(&jObj, &errorMsg);
 
     if (!deserialized)
       {
@@ -211,6 +231,7 @@ void MainWindow::loadProfile()
       ifs.open(filePath.toStdString(), std::ifstream::in);
 
       if (auto profile = loadProfileDatStream(ifs)) {
+        Foil::ChangeTransaction transaction(_fin.get());
         _fin->pSetProfile(profile);
         _fin->profile()->setEditable(false);
         _profileEditor->setFoil(_fin.get());
@@ -227,7 +248,7 @@ void MainWindow::loadProfile()
   QString errorMsg;
   QJsonObject jObj;
   if (!loadFileToJson(filePath, jObj)) return;
-  auto deserialized = JenSON::deserialize<Profile>(&jObj, &errorMsg);
+  auto deserialized = deserializeJson<Profile>(&jObj, &errorMsg);
 
   if (!deserialized)
     {
@@ -238,6 +259,7 @@ void MainWindow::loadProfile()
       return;
     }
 
+  Foil::ChangeTransaction transaction(_fin.get());
   _fin->pSetProfile(deserialized.release());
   _profileEditor->setFoil(_fin.get());
   _fin->onDeserialized();
@@ -263,7 +285,7 @@ void MainWindow::loadThickness()
   QString errorMsg;
   QJsonObject jObj;
   if (!loadFileToJson(filePath, jObj)) return;
-  auto deserialized = JenSON::deserialize<ThicknessProfile>(&jObj, &errorMsg);
+  auto deserialized = deserializeJson<ThicknessProfile>(&jObj, &errorMsg);
 
   if (!deserialized)
     {
@@ -362,6 +384,7 @@ void MainWindow::setFoil(Foil *foil)
 
     // connect dirty flagging
     connect(_outlineEditor->foilCalculator()->foil(), SIGNAL(foilChanged(Foil*)), this, SLOT(setDirty()));
+    connect(_outlineEditor->foilCalculator()->foil(), SIGNAL(foilReleased(Foil*)), this, SLOT(setDirty()));
     connect(_foilDataWidget, SIGNAL(depthChanged(qt::units::Length*)), this, SLOT(setDirty()));
     connect(_foilDataWidget, SIGNAL(thicknessChanged(qt::units::Length*)), this, SLOT(setDirty()));
 }
@@ -454,6 +477,18 @@ void MainWindow::createActions()
     quitAct->setStatusTip(tr("Quit finFoil"));
     connect(quitAct, SIGNAL(triggered()), this, SLOT(close()));
 
+    perfHudAct = new QAction(QIcon(), tr("&Performance Overlay"), this);
+    perfHudAct->setShortcut(QKeySequence(Qt::Key_F12));
+    perfHudAct->setCheckable(true);
+    perfHudAct->setStatusTip(tr("Show paint and calculation timings on the editors"));
+    connect(perfHudAct, &QAction::toggled, [](bool checked) { patheditor::PathEditorView::setHudVisible(checked); });
+
+    recordTraceAct = new QAction(QIcon(), tr("Record &Trace"), this);
+    recordTraceAct->setShortcut(QKeySequence(Qt::SHIFT + Qt::Key_F12));
+    recordTraceAct->setCheckable(true);
+    recordTraceAct->setStatusTip(tr("Record a timeline of calculations and file operations for chrome://tracing"));
+    connect(recordTraceAct, SIGNAL(toggled(bool)), this, SLOT(recordTrace(bool)));
+
     aboutAct = new QAction(QIcon(), tr("About f&inFoil"), this);
     connect(aboutAct, SIGNAL(triggered()), this, SLOT(about()));
 
@@ -493,6 +528,10 @@ void MainWindow::createMenus()
     threedMenu->addAction(stlExportAct);
 #endif
 
+    viewMenu = menuBar()->addMenu(tr("&View"));
+    viewMenu->addAction(perfHudAct);
+    viewMenu->addAction(recordTraceAct);
+
     aboutMenu = menuBar()->addMenu(tr("&About"));
     aboutMenu->addAction(aboutAct);
     aboutMenu->addAction(aboutQtAct);
@@ -522,6 +561,7 @@ bool MainWindow::loadFileToJson(const QString &path, QJsonObject &jObj)
         return false;
     }
 
+    hrlib::instrument::Zone zone(s_readJsonTimer);
     jObj = QJsonDocument::fromJson(file.readAll()).object();
     return true;
 }
@@ -531,7 +571,7 @@ bool MainWindow::loadFile(const QString &path)
     QString errorMsg;
     QJsonObject jObj;
     if (!loadFileToJson(path, jObj)) return false;
-    auto deserialized = JenSON::deserialize<Foil>(&jObj, &errorMsg);
+    auto deserialized = deserializeJson<Foil>(&jObj, &errorMsg);
 
     if (deserialized)
     {
@@ -577,6 +617,55 @@ QString MainWindow::askOpenFileName(const QString &fileFilter, const QString &ti
                                       fileFilter);
 }
 
+void MainWindow::startTrace(const QString &path)
+{
+    _tracePath = path;
+    if (recordTraceAct->isChecked())
+        hrlib::instrument::startTracing();
+    else
+        recordTraceAct->setChecked(true);
+}
+
+void MainWindow::recordTrace(bool record)
+{
+    if (record)
+    {
+        hrlib::instrument::startTracing();
+        statusBar()->showMessage(tr("Recording trace"), 2000);
+        return;
+    }
+
+    hrlib::instrument::stopTracing();
+
+    QString path = _tracePath;
+    _tracePath.clear();
+    if (path.isEmpty())
+        path = askSaveFileName(".json", tr("Chrome trace (*.json)"), tr("Save trace"));
+    if (path.isEmpty())
+        return;
+
+    if (writeTrace(path))
+        statusBar()->showMessage(tr("Trace saved"), 2000);
+}
+
+bool MainWindow::writeTrace(const QString &path)
+{
+    std::ostringstream trace;
+    hrlib::instrument::writeChromeTrace(trace);
+
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Text) || file.write(trace.str().c_str()) < 0)
+    {
+        QMessageBox::warning(this, tr("Cannot save trace"),
+                             tr("Cannot write to file %1:\n%2.")
+                             .arg(path)
+                             .arg(file.errorString()));
+        return false;
+    }
+
+    return true;
+}
+
 bool MainWindow::saveObjectToFile(const QObject *obj, const QString &path)
 {
     QFile file(path);
@@ -589,8 +678,11 @@ bool MainWindow::saveObjectToFile(const QObject *obj, const QString &path)
         return false;
     }
 
+    hrlib::instrument::Zone serializeZone(s_serializeTimer);
     QJsonDocument json(JenSON::serialize(obj));
+    serializeZone.end();
 
+    hrlib::instrument::Zone zone(s_writeJsonTimer);
     std::string long_utf8 = json.toJson(QJsonDocument::Compact).toStdString();
     std::string short_utf8 = hrlib::trim_json_floats(long_utf8);
 
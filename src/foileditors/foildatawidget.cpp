@@ -73,6 +73,18 @@ FoilDataWidget::FoilDataWidget(QWidget *parent) :
     connect(_layerEdit, SIGNAL(valueChanged(int)), this, SLOT(onLayerChange(int)));
 
 
+    //
+    // Contour tolerance section
+    //
+    _toleranceEdit = new QDoubleSpinBox();
+    _toleranceEdit->setDecimals(2);
+    _toleranceEdit->setRange(0.01, 2);
+    _toleranceEdit->setSingleStep(0.05);
+    _toleranceEdit->setSuffix(" %");
+    _toleranceEdit->setToolTip(tr("Maximum contour deviation, relative to the fin depth"));
+    formLayoutLeft->addRow(tr("Contour tolerance:"), _toleranceEdit);
+
+
     //
     // Depth section
     //
@@ -140,6 +152,8 @@ void FoilDataWidget::setFoilCalculator(FoilCalculator *foilCalculator)
     connect(_foilCalculator, SIGNAL(foilCalculated(FoilCalculator*)), this, SLOT(onFoilCalculated()));
 
     _layerEdit->setValue(_foilCalculator->contourThicknesses().count() + 1);
+    _toleranceEdit->setValue(_foilCalculator->contourTolerance() * 100);
+    connect(_toleranceEdit, SIGNAL(valueChanged(double)), this, SLOT(onToleranceChange(double)), Qt::UniqueConnection);
 
     _depth.setInternalValue(_foilCalculator->foil()->outline()->height());
     _depthEdit->setValue(_depth);
@@ -206,6 +220,11 @@ void FoilDataWidget::onLayerChange(int layerCount)
     _foilCalculator->setEquidistantContours(layerCount);
 }
 
+void FoilDataWidget::onToleranceChange(double tolerancePercent)
+{
+    _foilCalculator->setContourTolerance(tolerancePercent / 100);
+}
+
 void FoilDataWidget::onUnitSystemChange(const QString &system, bool showEvent)
 {
     if (system == "m")
@@ -26,6 +26,9 @@
 #include <QGroupBox>
 #include <QGraphicsScene>
 #include <QSplitter>
+#include <QGuiApplication>
+#include <QScreen>
+#include "foillogic/contourcache.hpp"
 #include "foillogic/foilcalculator.hpp"
 #include "patheditor/patheditorwidget.hpp"
 #include "foillogic/foil.hpp"
@@ -92,7 +95,12 @@ void OutlineEditor::setFoil(Foil *foil)
     if (_foilCalculator)
       _foilCalculator->setFoil(foil);
     else
-      _foilCalculator.reset(new FoilCalculator(foil));
+      _foilCalculator.reset(new FoilCalculator(foil, ContourCache::standard()));
+
+    // Calculate drag updates at most once per displayed frame
+    if (QScreen *screen = QGuiApplication::primaryScreen())
+      if (screen->refreshRate() > 0)
+        _foilCalculator->setFrameInterval(qRound(1000 / screen->refreshRate()));
 
     ThicknessContours *topContours = new ThicknessContours(_foilCalculator.get(), Side::Top);
     ThicknessContours *botContours = new ThicknessContours(_foilCalculator.get(), Side::Bottom);
@@ -119,6 +127,7 @@ void OutlineEditor::setGridUnitSize(qreal pxPerUnit)
 
 void OutlineEditor::onPathChange(Path *path)
 {
+    Foil::ChangeTransaction transaction(_foil);
     _foil->outline()->pSetPath(path);
     _foil->pSetOutline(_foil->outline());
     setFoil(_foil);
@@ -23,9 +23,16 @@
 #include "foileditors/outlineeditor/thicknesscontours.hpp"
 
 #include <QPainter>
+#include <QElapsedTimer>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
 #include <QtAlgorithms>
 #include <QGraphicsScene>
+#include "hrlib/instrument/instrument.hpp"
 #include "patheditor/path.hpp"
+#include "patheditor/patheditorview.hpp"
+#include "foillogic/contourbands.hpp"
+#include "foillogic/contourpolyline.hpp"
 #include "foillogic/foilcalculator.hpp"
 #include "foillogic/foil.hpp"
 #include "foillogic/outline.hpp"
@@ -35,6 +42,16 @@ using namespace foillogic;
 
 #define COLORMAP MAGMA
 
+// Tile size [device independent px] and number of cached tiles
+#define TILE_SIZE 256
+#define MAX_TILES 256
+// Deviation of the painted contours from the calculated ones [device px]
+#define MAX_SCREEN_ERROR 0.25
+
+namespace {
+    hrlib::instrument::Timer s_paintTimer("ThicknessContours::paint");
+}
+
 #include <vector>
 #include <array>
 const std::vector<std::array<float,3>> MAGMA = {{0.001462, 0.000466, 0.013866},
@@ -556,51 +573,215 @@ ThicknessContours::ThicknessContours(foillogic::FoilCalculator *calculator, Side
     _side = side;
     _nextDetailed = false;
     _calculator = calculator;
+    _paintTimes = { 0, 0, 0, 0 };
+    _pathTolerance = 0;
+    _curveFitting = false;
+    _fitError = 0;
+    if (_calculator->calculated())
+        _boundingRect = _calculator->foil()->outline()->path()->controlPointRect();
+
+    // exposedRect limits the rendered tiles
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    connect(_calculator, &FoilCalculator::foilCalculated, this, [this]() { invalidateTiles(); });
 }
 
-void ThicknessContours::paint(QPainter *painter, const QStyleOptionGraphicsItem * /*unused*/, QWidget * /*unused*/)
+void ThicknessContours::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-    if (_calculator->calculated())
+    hrlib::instrument::Zone zone(s_paintTimer);
+
+    // The calculator follows the detail needed by the view painted in
+    if (PathEditorView *view = widget ? dynamic_cast<PathEditorView*>(widget->parentWidget()) : nullptr)
+        _calculator->setView(_side, view->visibleSceneRect(), view->sceneScale());
+
+    if (!_calculator->calculated())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+    _paintTimes = { 0, 0, 0, 0 };
+
+    // Tiles are rendered in the zoomed frame in logical pixels, translations are applied
+    // when blitting them. The device pixel ratio is left to the tile pixmaps.
+    QTransform world = painter->worldTransform();
+    QTransform zoom(world.m11(), world.m12(), world.m21(), world.m22(), 0, 0);
+    if (zoom != _tileTransform || _tiles.size() > MAX_TILES)
+    {
+        _tiles.clear();
+        _tileTransform = zoom;
+    }
+    qreal dpr = painter->device()->devicePixelRatioF();
+    // Whole device pixels keep the tiles unfiltered
+    QPointF origin(qRound(world.dx() * dpr) / dpr, qRound(world.dy() * dpr) / dpr);
+
+    // Paint paths simplified to the zoom, rebuilt when zooming changes it by more than twice
+    // [device px per scene unit]
+    qreal scale = qSqrt(qAbs(zoom.determinant())) * dpr;
+    qreal tolerance = scale > 0 ? MAX_SCREEN_ERROR / scale : 0;
+    if (_pathTolerance <= 0 || tolerance < _pathTolerance / 2 || tolerance > _pathTolerance * 2)
+    {
+        QList<std::shared_ptr<const ContourPolyline> > polylines =
+                (_side == Side::Bottom)? _calculator->bottomPolylines() : _calculator->topPolylines();
+        _paths.clear();
+        _fitError = 0;
+        for (const auto &polyline : polylines)
+        {
+            if (_curveFitting)
+            {
+                qreal error;
+                _paths.append(std::make_shared<QPainterPath>(polyline->fitted(tolerance, &error)));
+                _fitError = qMax(_fitError, error);
+            }
+            else
+            {
+                _paths.append(std::make_shared<QPainterPath>(polyline->simplified(tolerance)));
+            }
+        }
+        _pathTolerance = tolerance;
+        _tiles.clear();
+    }
+
+    QRectF exposed = zoom.mapRect(option->exposedRect & boundingRect());
+    QList<QPair<int, int> > exposedTiles;
+    for (int j = qFloor(exposed.top() / TILE_SIZE); j * TILE_SIZE < exposed.bottom(); j++)
+        for (int i = qFloor(exposed.left() / TILE_SIZE); i * TILE_SIZE < exposed.right(); i++)
+            exposedTiles.append(qMakePair(i, j));
+
+    for (const QPair<int, int> &index : exposedTiles)
+    {
+        if (_tiles.contains(index))
+            continue;
+
+        QPixmap tile(QSize(TILE_SIZE, TILE_SIZE) * dpr);
+        tile.setDevicePixelRatio(dpr);
+        tile.fill(Qt::transparent);
+
+        QPainter tilePainter(&tile);
+        tilePainter.setRenderHints(painter->renderHints());
+        tilePainter.setPen(painter->pen());
+        tilePainter.setTransform(zoom * QTransform::fromTranslate(-index.first * TILE_SIZE, -index.second * TILE_SIZE));
+        renderContours(&tilePainter);
+
+        _tiles.insert(index, tile);
+        _paintTimes.renderedTiles++;
+    }
+    _paintTimes.render = timer.nsecsElapsed();
+
+    painter->save();
+    painter->resetTransform();
+    for (const QPair<int, int> &index : exposedTiles)
+        painter->drawPixmap(origin + QPointF(index.first, index.second) * TILE_SIZE, _tiles.value(index));
+    painter->restore();
+
+    _paintTimes.cachedTiles = exposedTiles.count() - _paintTimes.renderedTiles;
+    _paintTimes.blit = timer.nsecsElapsed() - _paintTimes.render;
+}
+
+ThicknessContours::~ThicknessContours()
+{
+}
+
+ThicknessContours::PaintTimes ThicknessContours::paintTimes() const
+{
+    return _paintTimes;
+}
+
+void ThicknessContours::setCurveFitting(bool fit)
+{
+    _curveFitting = fit;
+    invalidateTiles();
+}
+
+bool ThicknessContours::curveFitting() const
+{
+    return _curveFitting;
+}
+
+qreal ThicknessContours::fitError() const
+{
+    return _fitError;
+}
+
+void ThicknessContours::renderContours(QPainter *painter)
+{
+    const QList<std::shared_ptr<QPainterPath> > &contours = _paths;
+
+    if (_contourColors.length() != contours.length())
     {
         const int M = 255;
         int min = 20;
         int max = 255;
         int a = 100;
-        int increment = 0;
-
-        painter->setBrush(QColor((int)(COLORMAP[min][0]*M),
-                                 (int)(COLORMAP[min][1]*M),
-                                 (int)(COLORMAP[min][2]*M),
-                                 a));
-
-        QList<std::shared_ptr<QPainterPath> > contours = (_side == Side::Bottom)? _calculator->bottomContours() : _calculator->topContours();
+        int increment = contours.isEmpty() ? 0 : (max - min) / contours.length();
 
-        int numberOfContours = contours.length();
-        if (numberOfContours > 0)
+        _contourColors.clear();
+        for (int i = 0; i < contours.length(); i++)
         {
-            increment = (max - min) / numberOfContours;
-            foreach (const std::shared_ptr<QPainterPath>& contour, contours)
-            {
-                min += increment;
-                max -= increment;
-                painter->setBrush(QColor((int)(COLORMAP[min][0]*M),
+            min += increment;
+            max -= increment;
+            _contourColors.append(QColor((int)(COLORMAP[min][0]*M),
                                          (int)(COLORMAP[min][1]*M),
                                          (int)(COLORMAP[min][2]*M),
                                          a));
+        }
+    }
 
-                painter->drawPath(*contour);
-            }
+    // Each band is filled once with the colour of the stacked translucent contours covering it
+    std::shared_ptr<const ContourBands> bands = (_side == Side::Bottom)? _calculator->bottomBands() : _calculator->topBands();
+    if (bands != _bands)
+    {
+        _bands = bands;
+        _bandColors.clear();
+        for (int i = 0; _bands && i < _bands->count(); i++)
+        {
+            QList<QColor> covering;
+            for (int c : _bands->covering(i))
+                covering.append(_contourColors[c]);
+            _bandColors.append(ContourBands::composite(covering));
         }
     }
-}
 
-QRectF ThicknessContours::boundingRect() const
-{
-    if (!_calculator->calculated())
+    QPen pen = painter->pen();
+    painter->setPen(Qt::NoPen);
+    if (_bands)
+    {
+        for (int i = 0; i < _bands->count(); i++)
+        {
+            painter->setBrush(_bandColors[i]);
+            painter->drawPath(_bands->band(i));
+        }
+    }
+    else
     {
-        QRectF retVal;
-        return retVal;
+        // Drag previews come without bands, their contours are stacked
+        for (int i = 0; i < contours.length(); i++)
+        {
+            painter->setBrush(_contourColors[i]);
+            painter->drawPath(*contours[i]);
+        }
     }
 
-    return _calculator->foil()->outline()->path()->controlPointRect();
+    painter->setPen(pen);
+    painter->setBrush(Qt::NoBrush);
+    foreach (const std::shared_ptr<QPainterPath>& contour, contours)
+        painter->drawPath(*contour);
+}
+
+void ThicknessContours::invalidateTiles()
+{
+    _tiles.clear();
+    _paths.clear();
+    _pathTolerance = 0;
+    _contourColors.clear();
+    _bands.reset();
+
+    // The contours only move with a new calculation
+    prepareGeometryChange();
+    _boundingRect = _calculator->calculated() ? _calculator->foil()->outline()->path()->controlPointRect() : QRectF();
+
+    update();
+}
+
+QRectF ThicknessContours::boundingRect() const
+{
+    return _boundingRect;
 }
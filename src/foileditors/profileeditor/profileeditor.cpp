@@ -70,6 +70,10 @@ void ProfileEditor::setFoil(Foil *foil)
     _botProfile = new EditablePath(_foil->profile()->botProfile());
     symmetryChanged(_foil->profile()->symmetry());
 
+    // The mirrored profile is moved without drag events
+    connect(_foil->profile(), SIGNAL(profileChanged(Profile*)), _topProfile, SLOT(updateExtent()));
+    connect(_foil->profile(), SIGNAL(profileChanged(Profile*)), _botProfile, SLOT(updateExtent()));
+
     _pathEditor->addPath(_botProfile);
     _pathEditor->addPath(_topProfile);
 }
@@ -81,6 +85,8 @@ void ProfileEditor::setGridUnitSize(qreal pxPerUnit)
 
 void ProfileEditor::symmetryChanged(int sym)
 {
+    // setSymmetry moves all bottom points, recalculate once
+    Foil::ChangeTransaction transaction(_foil);
     bool editable = _foil->profile()->editable();
 
     switch (sym)
@@ -44,6 +44,7 @@ ThicknessEditor::ThicknessEditor(QWidget *parent) :
     _modeCombo->addItem(tr("Thickness"));
     _modeCombo->addItem(tr("Aspect Ratio"));
     connect(_modeCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(modeChanged(int)));
+    connect(_pathEditor, SIGNAL(pathChange(Path*)), this, SLOT(onPathChange(Path*)));
 
     QGroupBox* gb = new QGroupBox(tr("Thickness"));
     QVBoxLayout* gbLayout = new QVBoxLayout();
@@ -77,7 +78,7 @@ void ThicknessEditor::setFoil(Foil *foil)
 
 void ThicknessEditor::update()
 {
-    _pathEditor->scene()->update();
+    _botPath->updateExtent();
 }
 
 void ThicknessEditor::setImage(const QString &path)
@@ -104,3 +105,14 @@ void ThicknessEditor::modeChanged(int mode)
 
   _pathEditor->scene()->invalidate();
 }
+
+void ThicknessEditor::onPathChange(Path *path)
+{
+    // Split, remove and type toggle rebuild the thickness profile, recalculate once.
+    // The bottom path is replaced as well, the editor follows in setFoil.
+    Foil::ChangeTransaction transaction(_foil);
+    disconnect(_foil->thicknessProfile(), SIGNAL(mirrored()), this, SLOT(update()));
+    _foil->thicknessProfile()->pSetTopProfile(path);
+    _foil->notifyReleased();
+    setFoil(_foil);
+}
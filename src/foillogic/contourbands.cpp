@@ -0,0 +1,88 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "foillogic/contourbands.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace foillogic;
+
+ContourBands::ContourBands(const QList<std::shared_ptr<QPainterPath> > &contours)
+{
+    // Nested contours enclose each other, order them by enclosed area
+    std::vector<qreal> areas;
+    for (const auto &contour : contours)
+    {
+        QRectF rect = contour->boundingRect();
+        areas.push_back(rect.width() * rect.height());
+    }
+    std::vector<int> nesting(contours.count());
+    std::iota(nesting.begin(), nesting.end(), 0);
+    std::stable_sort(nesting.begin(), nesting.end(), [&areas](int a, int b) { return areas[a] > areas[b]; });
+
+    for (size_t i=0; i<nesting.size(); i++)
+    {
+        const QPainterPath &contour = *contours[nesting[i]];
+        if (i+1 < nesting.size())
+            _bands.append(contour.subtracted(*contours[nesting[i+1]]));
+        else
+            _bands.append(contour);
+        _nesting.append(nesting[i]);
+    }
+}
+
+int ContourBands::count() const
+{
+    return _bands.count();
+}
+
+const QPainterPath &ContourBands::band(int i) const
+{
+    return _bands[i];
+}
+
+QList<int> ContourBands::covering(int i) const
+{
+    QList<int> indices = _nesting.mid(0, i+1);
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+QColor ContourBands::composite(const QList<QColor> &colors)
+{
+    // premultiplied source over: dst = src + dst * (1 - src alpha)
+    qreal r = 0, g = 0, b = 0, a = 0;
+    for (const QColor &color : colors)
+    {
+        qreal alpha = color.alphaF();
+        r = color.redF() * alpha + r * (1 - alpha);
+        g = color.greenF() * alpha + g * (1 - alpha);
+        b = color.blueF() * alpha + b * (1 - alpha);
+        a = alpha + a * (1 - alpha);
+    }
+
+    if (a <= 0)
+        return QColor(0, 0, 0, 0);
+    return QColor::fromRgbF(r/a, g/a, b/a, a);
+}
@@ -0,0 +1,344 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "foillogic/contourcache.hpp"
+
+#include <cstring>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include "hrlib/instrument/instrument.hpp"
+#include "foillogic/contourpolyline.hpp"
+#include "foillogic/derived.hpp"
+#include "foillogic/foilgeometry.hpp"
+#include "patheditor/pathsnapshot.hpp"
+
+using namespace foillogic;
+
+namespace {
+    // Increment on any change in the file layout or in the calculations
+    const quint32 formatVersion = 2;
+    const char magic[4] = { 'F', 'F', 'C', 'C' };
+
+    // A few hundred designs at the default layer count
+    const qint64 DEFAULT_MAX_SIZE = 64 * 1024 * 1024;
+
+    DerivedCounter s_diskCounter("ContourCache");
+    hrlib::instrument::Timer s_loadTimer("ContourCache::load");
+    hrlib::instrument::Timer s_storeTimer("ContourCache::store");
+
+    struct Header
+    {
+        char magic[4];
+        quint32 version;
+        quint32 topCount;
+        quint32 botCount;
+        double area;
+        double sweep;
+        double thickness;
+    };
+
+    void addReal(QCryptographicHash &hash, qreal value)
+    {
+        double v = value;
+        hash.addData(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+    void addPath(QCryptographicHash &hash, const patheditor::PathSnapshot &path)
+    {
+        auto items = path.bezierItems();
+        addReal(hash, items.size());
+        for (const auto &item : items)
+        {
+            addReal(hash, item.size());
+            for (const QPointF &p : item)
+            {
+                addReal(hash, p.x());
+                addReal(hash, p.y());
+            }
+        }
+    }
+
+    template<typename T>
+    void append(QByteArray &buffer, const T &value)
+    {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // Bounds checked reads from the file contents
+    struct Reader
+    {
+        const uchar *pos;
+        const uchar *end;
+
+        template<typename T>
+        bool read(T &value)
+        {
+            if (end - pos < qint64(sizeof(T)))
+                return false;
+            std::memcpy(&value, pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+    };
+
+    // contour: point count, island count, first point of each island, float x and y per point
+    void appendContour(QByteArray &buffer, const ContourPolyline &contour)
+    {
+        append(buffer, quint32(contour.pointCount()));
+        append(buffer, quint32(contour.islandCount()));
+        for (int i=0; i<contour.islandCount(); i++)
+            append(buffer, quint32(contour.islandBegin(i)));
+        for (int i=0; i<contour.pointCount(); i++)
+        {
+            QPointF p = contour.point(i);
+            append(buffer, float(p.x()));
+            append(buffer, float(p.y()));
+        }
+    }
+
+    bool readContour(Reader &reader, ContourPolyline &contour)
+    {
+        quint32 pointCount, islandCount;
+        if (!reader.read(pointCount) || !reader.read(islandCount) || islandCount > pointCount)
+            return false;
+
+        std::vector<quint32> islands(islandCount);
+        for (quint32 &i : islands)
+            if (!reader.read(i))
+                return false;
+
+        size_t nextIsland = 0;
+        for (quint32 i=0; i<pointCount; i++)
+        {
+            float x, y;
+            if (!reader.read(x) || !reader.read(y))
+                return false;
+
+            if (i == 0 || (nextIsland < islands.size() && islands[nextIsland] == i))
+                contour.moveTo(x, y);
+            else
+                contour.lineTo(x, y);
+
+            if (nextIsland < islands.size() && islands[nextIsland] == i)
+                nextIsland++;
+        }
+        return true;
+    }
+}
+
+ContourCache::ContourCache(const QString &directory) :
+    _directory(directory), _maxSize(DEFAULT_MAX_SIZE), _size(-1)
+{
+}
+
+std::shared_ptr<ContourCache> ContourCache::standard()
+{
+    static std::shared_ptr<ContourCache> cache =
+            std::make_shared<ContourCache>(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/contours");
+    return cache;
+}
+
+QByteArray ContourCache::key(const FoilGeometry &geometry, const QList<qreal> &contourThicknesses,
+                             qreal tolerance, size_t resolution)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    addReal(hash, formatVersion);
+
+    addPath(hash, *geometry.outline);
+    addPath(hash, *geometry.topProfile);
+    addPath(hash, *geometry.botProfile);
+    addPath(hash, *geometry.topThickness);
+    addPath(hash, *geometry.botThickness);
+
+    addReal(hash, geometry.outlineHeight);
+    addReal(hash, geometry.thickness);
+    addReal(hash, geometry.symmetry);
+    addReal(hash, geometry.aspectRatioEnforced);
+
+    addReal(hash, contourThicknesses.count());
+    for (qreal thickness : contourThicknesses)
+        addReal(hash, thickness);
+    addReal(hash, tolerance);
+    addReal(hash, resolution);
+
+    return hash.result();
+}
+
+QString ContourCache::directory() const
+{
+    return _directory;
+}
+
+qint64 ContourCache::maxSize() const
+{
+    return _maxSize;
+}
+
+void ContourCache::setMaxSize(qint64 maxSize)
+{
+    _maxSize = maxSize;
+}
+
+QString ContourCache::filePath(const QByteArray &key) const
+{
+    return _directory + "/" + QString::fromLatin1(key.toHex()) + ".ffc";
+}
+
+bool ContourCache::load(const QByteArray &key, Entry *entry) const
+{
+    hrlib::instrument::Zone zone(s_loadTimer);
+
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        s_diskCounter.miss();
+        return false;
+    }
+
+    // Read at once, the points are converted into the contours anyway
+    QByteArray data = file.readAll();
+    const uchar *begin = reinterpret_cast<const uchar*>(data.constData());
+    Reader reader = { begin, begin + data.size() };
+    Header header;
+    bool valid = reader.read(header) &&
+                 std::memcmp(header.magic, magic, sizeof(magic)) == 0 &&
+                 header.version == formatVersion;
+
+    Entry loaded;
+    QList<std::shared_ptr<const ContourPolyline> > contours;
+    for (quint32 i=0; valid && i<header.topCount + header.botCount; i++)
+    {
+        // 0 for a contour that follows, or 1 + the index of the earlier one it shares
+        quint32 reference;
+        valid = reader.read(reference) && reference <= quint32(contours.count());
+        if (!valid)
+            break;
+
+        std::shared_ptr<const ContourPolyline> contour;
+        if (reference > 0)
+            contour = contours[reference - 1];
+        else
+        {
+            auto read = std::make_shared<ContourPolyline>();
+            valid = readContour(reader, *read);
+            read->squeeze();
+            contour = read;
+        }
+        contours.append(contour);
+        (i < header.topCount ? loaded.topContours : loaded.botContours).append(contour);
+    }
+
+    if (valid)
+    {
+        loaded.area = header.area;
+        loaded.sweep = header.sweep;
+        loaded.thickness = header.thickness;
+        *entry = loaded;
+
+        // Recently used files are pruned last. Setting the time needs a handle with
+        // write access on Windows, appending leaves the contents untouched.
+        file.close();
+        QFile touched(file.fileName());
+        if (!touched.open(QIODevice::Append) ||
+            !touched.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime))
+            qWarning("ContourCache: cannot refresh %s, it is pruned as if unused", qPrintable(file.fileName()));
+        s_diskCounter.hit();
+    }
+    else
+        s_diskCounter.miss();
+    return valid;
+}
+
+bool ContourCache::store(const QByteArray &key, const Entry &entry) const
+{
+    hrlib::instrument::Zone zone(s_storeTimer);
+
+    if (!QDir().mkpath(_directory))
+        return false;
+
+    QByteArray buffer;
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = formatVersion;
+    header.topCount = entry.topContours.count();
+    header.botCount = entry.botContours.count();
+    header.area = entry.area;
+    header.sweep = entry.sweep;
+    header.thickness = entry.thickness;
+    append(buffer, header);
+
+    // Symmetric foils share their contours between both sides, store them once
+    QList<const ContourPolyline*> stored;
+    for (const auto &contour : entry.topContours + entry.botContours)
+    {
+        int index = stored.indexOf(contour.get());
+        append(buffer, quint32(index + 1));
+        if (index < 0)
+            appendContour(buffer, *contour);
+        stored.append(contour.get());
+    }
+
+    // Written to a temporary file and renamed, readers never see partial files
+    QString path = filePath(key);
+    QFileInfo replaced(path);
+    qint64 replacedSize = replaced.exists() ? replaced.size() : 0;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(buffer);
+    if (!file.commit())
+        return false;
+
+    // The directory is only listed by the first store and when the running total
+    // exceeds the maximum size
+    std::lock_guard<std::mutex> lock(_sizeMutex);
+    if (_size >= 0)
+        _size += buffer.size() - replacedSize;
+    if (_size < 0 || _size > _maxSize)
+        prune();
+    return true;
+}
+
+void ContourCache::prune() const
+{
+    // Newest first, loads refresh the modification time
+    QFileInfoList files = QDir(_directory).entryInfoList(QStringList("*.ffc"), QDir::Files, QDir::Time);
+    _size = 0;
+    for (const QFileInfo &info : files)
+        _size += info.size();
+    if (_size <= _maxSize)
+        return;
+
+    // Down to below the maximum, leaving room for the next stores
+    _size = 0;
+    for (const QFileInfo &info : files)
+    {
+        if (_size + info.size() > _maxSize * 3 / 4 && QFile::remove(info.filePath()))
+            continue;
+        _size += info.size();
+    }
+}
@@ -0,0 +1,224 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "foillogic/contourpolyline.hpp"
+
+#include <limits>
+#include <utility>
+#include <QtMath>
+#include "hrlib/curvefit/curvefit.hpp"
+
+using namespace foillogic;
+
+ContourPolyline::ContourPolyline()
+{
+}
+
+void ContourPolyline::moveTo(qreal x, qreal y)
+{
+    // Like QPainterPath, a moveTo directly after a moveTo replaces it
+    if (!_islands.empty() && _islands.back() == pointCount() - 1)
+    {
+        _xy[_xy.size() - 2] = x;
+        _xy[_xy.size() - 1] = y;
+        return;
+    }
+
+    _islands.push_back(pointCount());
+    _xy.push_back(x);
+    _xy.push_back(y);
+}
+
+void ContourPolyline::lineTo(qreal x, qreal y)
+{
+    if (_islands.empty())
+        _islands.push_back(0);
+    _xy.push_back(x);
+    _xy.push_back(y);
+}
+
+void ContourPolyline::squeeze()
+{
+    _xy.shrink_to_fit();
+    _islands.shrink_to_fit();
+}
+
+int ContourPolyline::pointCount() const
+{
+    return int(_xy.size() / 2);
+}
+
+QPointF ContourPolyline::point(int i) const
+{
+    return QPointF(_xy[2*i], _xy[2*i+1]);
+}
+
+int ContourPolyline::islandCount() const
+{
+    return int(_islands.size());
+}
+
+int ContourPolyline::islandBegin(int i) const
+{
+    return _islands[i];
+}
+
+int ContourPolyline::islandEnd(int i) const
+{
+    return size_t(i+1) < _islands.size() ? _islands[i+1] : pointCount();
+}
+
+QRectF ContourPolyline::boundingRect() const
+{
+    if (_xy.empty())
+        return QRectF();
+
+    float minX = std::numeric_limits<float>::max(), minY = minX;
+    float maxX = std::numeric_limits<float>::lowest(), maxY = maxX;
+    for (size_t i=0; i<_xy.size(); i+=2)
+    {
+        minX = qMin(minX, _xy[i]);
+        maxX = qMax(maxX, _xy[i]);
+        minY = qMin(minY, _xy[i+1]);
+        maxY = qMax(maxY, _xy[i+1]);
+    }
+    return QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+size_t ContourPolyline::memoryUsage() const
+{
+    return _xy.capacity() * sizeof(float) + _islands.capacity() * sizeof(int);
+}
+
+std::shared_ptr<QPainterPath> ContourPolyline::path() const
+{
+    std::lock_guard<std::mutex> lock(_pathMutex);
+    if (!_path)
+    {
+        _path = std::make_shared<QPainterPath>();
+        _path->reserve(pointCount());
+        for (int i=0; i<islandCount(); i++)
+        {
+            _path->moveTo(point(islandBegin(i)));
+            for (int j=islandBegin(i)+1; j<islandEnd(i); j++)
+                _path->lineTo(point(j));
+        }
+    }
+    return _path;
+}
+
+QPainterPath ContourPolyline::simplified(qreal tolerance) const
+{
+    QPainterPath simplified;
+    std::vector<bool> keep;
+    std::vector<std::pair<int, int> > spans;
+    for (int island=0; island<islandCount(); island++)
+    {
+        int begin = islandBegin(island);
+        int end = islandEnd(island);
+        keep.assign(end - begin, false);
+        keep.front() = keep.back() = true;
+
+        // Keep the point farthest from the chord of each span while it exceeds the tolerance
+        spans.clear();
+        spans.push_back(std::make_pair(begin, end - 1));
+        while (!spans.empty())
+        {
+            std::pair<int, int> span = spans.back();
+            spans.pop_back();
+            if (span.second - span.first < 2)
+                continue;
+
+            QPointF a = point(span.first);
+            QPointF ab = point(span.second) - a;
+            qreal length = qSqrt(QPointF::dotProduct(ab, ab));
+
+            qreal maxDistance = -1;
+            int farthest = span.first;
+            for (int i=span.first+1; i<span.second; i++)
+            {
+                QPointF ap = point(i) - a;
+                // Distance to the chord, or to its start when it is closed
+                qreal distance = length > 0 ? qAbs(ab.x() * ap.y() - ab.y() * ap.x()) / length
+                                            : qSqrt(QPointF::dotProduct(ap, ap));
+                if (distance > maxDistance)
+                {
+                    maxDistance = distance;
+                    farthest = i;
+                }
+            }
+
+            if (maxDistance > tolerance)
+            {
+                keep[farthest - begin] = true;
+                spans.push_back(std::make_pair(span.first, farthest));
+                spans.push_back(std::make_pair(farthest, span.second));
+            }
+        }
+
+        simplified.moveTo(point(begin));
+        for (int i=begin+1; i<end; i++)
+            if (keep[i - begin])
+                simplified.lineTo(point(i));
+    }
+    return simplified;
+}
+
+QPainterPath ContourPolyline::fitted(qreal tolerance, qreal *maxError) const
+{
+    QPainterPath fitted;
+    if (maxError)
+        *maxError = 0;
+
+    std::vector<hrlib::vertex<2> > points;
+    for (int island=0; island<islandCount(); island++)
+    {
+        // Coincident points have no tangent to fit to
+        points.clear();
+        for (int i=islandBegin(island); i<islandEnd(island); i++)
+        {
+            QPointF p = point(i);
+            if (points.empty() || points.back()[0] != p.x() || points.back()[1] != p.y())
+                points.push_back({ p.x(), p.y() });
+        }
+
+        double error = 0;
+        auto knots = points.size() > 2 ? hrlib::curve_fit<2>::cubic(points, tolerance, &error)
+                                       : std::vector<std::array<hrlib::vertex<2>,3> >();
+        if (knots.empty())
+        {
+            fitted.moveTo(point(islandBegin(island)));
+            for (size_t i=1; i<points.size(); i++)
+                fitted.lineTo(points[i][0], points[i][1]);
+            continue;
+        }
+
+        fitted.moveTo(knots[0][1][0], knots[0][1][1]);
+        for (size_t k=1; k<knots.size(); k++)
+            fitted.cubicTo(knots[k-1][2][0], knots[k-1][2][1],
+                           knots[k][0][0], knots[k][0][1],
+                           knots[k][1][0], knots[k][1][1]);
+        if (maxError)
+            *maxError = qMax(*maxError, qreal(error));
+    }
+    return fitted;
+}
@@ -0,0 +1,66 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "foillogic/derived.hpp"
+
+#include <mutex>
+
+using namespace foillogic;
+
+namespace {
+    std::mutex &registryMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::vector<DerivedCounter*> &registry()
+    {
+        static std::vector<DerivedCounter*> counters;
+        return counters;
+    }
+}
+
+DerivedCounter::DerivedCounter(const char *name) :
+    _name(name), _hits(0), _misses(0)
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().push_back(this);
+}
+
+double DerivedCounter::hitRate() const
+{
+    unsigned long long hits = _hits, total = hits + _misses;
+    return total ? double(hits) / total : 0;
+}
+
+void DerivedCounter::reset()
+{
+    _hits = 0;
+    _misses = 0;
+}
+
+std::vector<DerivedCounter*> DerivedCounter::all()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    return registry();
+}
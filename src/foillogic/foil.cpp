@@ -32,6 +32,8 @@
 #include "foillogic/outline.hpp"
 #include "foillogic/profile.hpp"
 #include "foillogic/thicknessprofile.hpp"
+#include "foillogic/foilgeometry.hpp"
+#include "patheditor/pathsnapshot.hpp"
 #include "patheditor/pathdecorators.hpp"
 
 SERIALIZABLE(foillogic::Base, base)
@@ -48,12 +50,25 @@ namespace {
       Mirror = 0x1,
       Default = None
     }; };
+
+  struct Notification { enum e {
+      Changed = 0x1,
+      Released = 0x2
+    }; };
+
+  DerivedCounter s_outlineTopCounter("Foil::outlineTop");
+  DerivedCounter s_thicknessSpanCounter("Foil::thicknessSpan");
+  DerivedCounter s_profileExtremeCounter("Foil::profileExtreme");
 }
 
 Foil::Foil(QObject *parent) :
     QObject(parent),
+    _thickness(0.01 * si::meter), // 1cm
     _flags(Flags::None),
-    _thickness(0.01 * si::meter) // 1cm
+    _outlineTop(s_outlineTopCounter),
+    _thicknessSpan(s_thicknessSpanCounter),
+    _topProfileMaxY(s_profileExtremeCounter),
+    _botProfileMinY(s_profileExtremeCounter)
 {
     initOutline();
     initProfile();
@@ -177,12 +192,26 @@ void Foil::connectThickness()
 
 void Foil::onFoilChanged()
 {
-    emit foilChanged(this);
+    notify(Notification::Changed);
 }
 
 void Foil::onFoilReleased()
 {
-    emit foilReleased(this);
+    notifyReleased();
+}
+
+void Foil::notifyReleased()
+{
+    notify(Notification::Released);
+}
+
+void Foil::sendNotifications(unsigned flags)
+{
+    // The release calculation covers the changes before it
+    if (flags & Notification::Released)
+        emit foilReleased(this);
+    else if (flags & Notification::Changed)
+        emit foilChanged(this);
 }
 
 void Foil::onProfileChanged()
@@ -192,11 +221,29 @@ void Foil::onProfileChanged()
 }
 
 
+qreal Foil::outlineTop()
+{
+    return _outlineTop.get([this]() {
+        qreal t_top = 0.3;
+        return _outline->path()->minY(&t_top);
+    }, _outline->path()->snapshot());
+}
+
+qreal Foil::thicknessSpan()
+{
+    Path *top = _thicknessProfile->topProfile();
+    Path *bot = _thicknessProfile->botProfile();
+    return _thicknessSpan.get([top, bot]() {
+        qreal t_top = 0;
+        qreal topMinY = top->minY(&t_top);
+        return topMinY - bot->maxY(&t_top);
+    }, top->snapshot(), bot->snapshot());
+}
+
 std::unique_ptr<IPath> foillogic::Foil::outlineSI()
 {
-    qreal t_top = 0.3;
     quantity<si::length, qreal> height = _outline->height();
-    qreal s = height.value() / -_outline->path()->minY(&t_top);
+    qreal s = height.value() / -outlineTop();
     // Flip over the x-axis, since the internal screen coordinates have the y-axis pointing downwards.
     return decorate<PathScaleDecorator>(_outline->path(), s, -s);
 }
@@ -213,7 +260,6 @@ namespace {
         std::pair<qreal, qreal> retVal;
 
         // determine the x scaling factor
-        auto pOutlineSI = self->outlineSI();
         retVal.first = qAbs(scaleFactorX(self->profile()->topProfile(), 1));
 
         // determine the y scaling factor
@@ -252,9 +298,8 @@ namespace {
 
         // determine the y scaling factor
         quantity<si::length, qreal> thicknessSI = self->thickness();
-        qreal t_top = 0;
         // Flip over the x-axis, since the internal screen coordinates have the y-axis pointing downwards.
-        retVal.second = -qAbs(thicknessSI.value() / (self->thicknessProfile()->topProfile()->minY(&t_top) - self->thicknessProfile()->botProfile()->maxY(&t_top)));
+        retVal.second = -qAbs(thicknessSI.value() / self->thicknessSpan());
 
         return retVal;
     }
@@ -349,6 +394,33 @@ bool Foil::aspectRatioEnforced() const
     return _thicknessProfile->aspectRatioEnforced();
 }
 
+std::shared_ptr<const FoilGeometry> Foil::snapshot()
+{
+    auto geometry = std::make_shared<FoilGeometry>();
+
+    geometry->outline = _outline->path()->snapshot();
+    geometry->topProfile = _profile->topProfile()->snapshot();
+    geometry->botProfile = _profile->botProfile()->snapshot();
+    geometry->topThickness = _thicknessProfile->topProfile()->snapshot();
+    geometry->botThickness = _thicknessProfile->botProfile()->snapshot();
+
+    geometry->outlineHeight = _outline->height().value();
+    geometry->thickness = _thickness.value();
+
+    geometry->symmetry = _profile->symmetry();
+    geometry->thicknessRatio = _profile->thicknessRatio();
+    geometry->pxThickness = _profile->pxThickness();
+    geometry->topProfileTop = _profile->topProfileTop();
+    geometry->bottomProfileTop = _profile->bottomProfileTop();
+
+    geometry->topProfileMaxY = _topProfileMaxY.get([this]() { return _profile->topProfile()->maxY(); }, geometry->topProfile);
+    geometry->botProfileMinY = _botProfileMinY.get([this]() { return _profile->botProfile()->minY(); }, geometry->botProfile);
+
+    geometry->aspectRatioEnforced = aspectRatioEnforced();
+
+    return geometry;
+}
+
 boost::units::quantity<boost::units::si::length, qreal> Foil::thickness() const
 {
     return _thickness;
@@ -15,33 +15,71 @@
 
 #include <QtMath>
 #include "patheditor/path.hpp"
+#include "foillogic/contourbands.hpp"
+#include "foillogic/contourcache.hpp"
 #include "foillogic/contourcalculator.hpp"
+#include "foillogic/contourpolyline.hpp"
 #include "foillogic/foil.hpp"
+#include "foillogic/foilgeometry.hpp"
 #include "foillogic/profile.hpp"
 #include "foillogic/outline.hpp"
-#include "foillogic/thicknessprofile.hpp"
-#include "hrlib/patterns/decorator.hpp"
-#include "patheditor/pathdecorators.hpp"
+#include "patheditor/pathsnapshot.hpp"
+#include "hrlib/concurrent/scheduler.hpp"
+#include "hrlib/instrument/instrument.hpp"
 
 using namespace foillogic;
 using namespace boost::units;
-using namespace hrlib::patterns;
+using namespace hrlib::concurrent;
 
 #ifdef QT_DEBUG
-    const size_t LOW_SEC = 16;
-    const size_t HI_SEC = 64;
+    const qreal LOW_TOL_FACTOR = 32;
+    const qreal HI_TOL_FACTOR = 8;
     const size_t LOW_RES = 20;
     const size_t HI_RES = 50;
 #else
-    const size_t LOW_SEC = 128;
-    const size_t HI_SEC = 512;
+    const qreal LOW_TOL_FACTOR = 4;
+    const qreal HI_TOL_FACTOR = 1;
     const size_t LOW_RES = 200;
     const size_t HI_RES = 500;
 #endif
 
-FoilCalculator::FoilCalculator(Foil *foil) :
-    QObject(), _calculated(false)
+namespace {
+    DerivedCounter s_areaSweepCounter("FoilCalculator::areaSweep");
+    DerivedCounter s_levelsCounter("FoilCalculator::levels");
+
+    // Calculation stages, see hrlib::instrument
+    hrlib::instrument::Timer s_calculateTimer("FoilCalculator::calculate");
+    // Request to result latency of the shown calculations, its rate is the calculation rate
+    hrlib::instrument::Timer s_calculationsTimer("FoilCalculator::calculations");
+    hrlib::instrument::Timer s_sectionsTimer("FoilCalculator::sections");
+    hrlib::instrument::Timer s_contoursTimer("FoilCalculator::contours");
+    hrlib::instrument::Timer s_bandsTimer("FoilCalculator::bands");
+    hrlib::instrument::Timer s_areaSweepTimer("AreaSweepCalculator::run");
+
+    // Enough for toggling between a few layer schedules
+    const size_t LEVEL_CACHE_SIZE = 64;
+
+    // Level of detail of calculations for a view
+    const qreal MAX_SCREEN_ERROR = 0.5; // [px]
+    const size_t MIN_VIEW_RES = 20;
+    const qreal VIEW_MARGIN = 0.5;      // refined around the view, relative to its height
+    const int VIEW_DELAY = 100;         // [ms] settle time of zooming and scrolling
+}
+
+FoilCalculator::FoilCalculator(Foil *foil, std::shared_ptr<ContourCache> cache) :
+    QObject(), _calculated(false), _contourTolerance(0.001), _contourCache(cache), _frameInterval(16),
+    _areaSweep(s_areaSweepCounter), _levels(s_levelsCounter, LEVEL_CACHE_SIZE),
+    _generation(0), _appliedGeneration(0), _requested(0), _previewRunning(false), _previewPending(false), _filling(false)
 {
+  _viewScales[Side::Top] = _viewScales[Side::Bottom] = 0;
+  _calculatedDetail = { 0, 0, 0, 1 };
+
+  _frameTimer.setSingleShot(true);
+  connect(&_frameTimer, SIGNAL(timeout()), this, SLOT(onFrame()));
+  _viewTimer.setSingleShot(true);
+  connect(&_viewTimer, SIGNAL(timeout()), this, SLOT(onViewChanged()));
+  connect(this, &FoilCalculator::calculationFinished, this, &FoilCalculator::onCalculationFinished, Qt::QueuedConnection);
+
   setFoil(foil);
 }
 
@@ -52,6 +90,9 @@ Foil *FoilCalculator::foil()
 
 void FoilCalculator::setFoil(Foil *foil)
 {
+    // Calculations still running on the previous foil are dropped
+    _appliedGeneration = _generation;
+    _previewPending = false;
     _foil = foil;
 
     setEquidistantContours(_foil->layerCount());
@@ -71,6 +112,27 @@ void FoilCalculator::setContourThicknesses(QList<qreal> thicknesses)
     calculate(false);
 }
 
+qreal FoilCalculator::contourTolerance() const
+{
+    return _contourTolerance;
+}
+
+void FoilCalculator::setContourTolerance(qreal tolerance)
+{
+    _contourTolerance = tolerance;
+    calculate(false);
+}
+
+std::shared_ptr<ContourCache> FoilCalculator::contourCache() const
+{
+    return _contourCache;
+}
+
+void FoilCalculator::setContourCache(std::shared_ptr<ContourCache> cache)
+{
+    _contourCache = cache;
+}
+
 void FoilCalculator::setEquidistantContours(int contourCount)
 {
     _foil->setLayerCount(contourCount);
@@ -87,20 +149,96 @@ void FoilCalculator::setEquidistantContours(int contourCount)
     setContourThicknesses(thicknesses);
 }
 
-QList<std::shared_ptr<QPainterPath> > FoilCalculator::topContours()
+int FoilCalculator::frameInterval() const
+{
+    return _frameInterval;
+}
+
+void FoilCalculator::setFrameInterval(int interval)
+{
+    _frameInterval = interval;
+}
+
+QList<std::shared_ptr<const ContourPolyline> > FoilCalculator::topPolylines() const
 {
     return _topContours;
 }
 
-QList<std::shared_ptr<QPainterPath> > FoilCalculator::bottomContours()
+QList<std::shared_ptr<const ContourPolyline> > FoilCalculator::bottomPolylines() const
 {
     return _botContours;
 }
 
-struct invQPainterPath
+namespace {
+    QList<std::shared_ptr<QPainterPath> > paths(const QList<std::shared_ptr<const ContourPolyline> > &polylines)
+    {
+        QList<std::shared_ptr<QPainterPath> > result;
+        for (const auto &polyline : polylines)
+            result.append(polyline->path());
+        return result;
+    }
+
+    QList<QPainterPath> curves(const QList<std::shared_ptr<const ContourPolyline> > &polylines,
+                               qreal tolerance, qreal *maxError)
+    {
+        QList<QPainterPath> result;
+        if (maxError)
+            *maxError = 0;
+        for (const auto &polyline : polylines)
+        {
+            qreal error;
+            result.append(polyline->fitted(tolerance, &error));
+            if (maxError)
+                *maxError = qMax(*maxError, error);
+        }
+        return result;
+    }
+
+    // Within a fraction of the calculation tolerance [scene units], on fewer points
+    QList<std::shared_ptr<QPainterPath> > bandContours(const QList<std::shared_ptr<const ContourPolyline> > &polylines,
+                                                      qreal tolerance)
+    {
+        QList<std::shared_ptr<QPainterPath> > result;
+        for (const auto &polyline : polylines)
+            result.append(std::make_shared<QPainterPath>(polyline->simplified(tolerance / 4)));
+        return result;
+    }
+}
+
+std::shared_ptr<const ContourBands> FoilCalculator::topBands() const
 {
-  QPainterPath* _p;
-  explicit invQPainterPath(QPainterPath *p) : _p(p) {}
+    return _topBands;
+}
+
+std::shared_ptr<const ContourBands> FoilCalculator::bottomBands() const
+{
+    return _botBands;
+}
+
+QList<std::shared_ptr<QPainterPath> > FoilCalculator::topContours()
+{
+    return paths(_topContours);
+}
+
+QList<std::shared_ptr<QPainterPath> > FoilCalculator::bottomContours()
+{
+    return paths(_botContours);
+}
+
+QList<QPainterPath> FoilCalculator::topCurves(qreal tolerance, qreal *maxError) const
+{
+    return curves(_topContours, tolerance, maxError);
+}
+
+QList<QPainterPath> FoilCalculator::bottomCurves(qreal tolerance, qreal *maxError) const
+{
+    return curves(_botContours, tolerance, maxError);
+}
+
+struct invPolyline
+{
+  ContourPolyline* _p;
+  explicit invPolyline(ContourPolyline *p) : _p(p) {}
 
   inline void lineTo(qreal x, qreal y) { _p->lineTo(x, -y); }
   inline void lineTo(const QPointF &p) { lineTo(p.x(), p.y()); }
@@ -109,101 +247,531 @@ struct invQPainterPath
   inline void moveTo(const QPointF &p) { moveTo(p.x(), p.y()); }
 };
 
+void FoilCalculator::setView(Side::e side, const QRectF &visible, qreal scale)
+{
+    _views[side] = visible;
+    _viewScales[side] = visible.isNull() ? 0 : scale;
+
+    // Recalculate when the view shows sections that were not refined,
+    // or when zoomed in beyond the calculated tolerance
+    Detail needed;
+    if (!_calculated || !viewDetail(*_foil->snapshot(), false, 0, &needed))
+        return;
+    if (needed.hMin < needed.hMax &&
+        (needed.hMin < _calculatedDetail.hMin || needed.hMax > _calculatedDetail.hMax ||
+         needed.tolerance < _calculatedDetail.tolerance / 2))
+    {
+        if (!_viewTimer.isActive())
+            _viewTimer.start(VIEW_DELAY);
+    }
+}
+
+bool FoilCalculator::viewDetail(const FoilGeometry &geometry, bool fastCalc, qreal margin, Detail *detail) const
+{
+    QRectF visible;
+    qreal scale = 0;
+    for (Side::e side : { Side::Top, Side::Bottom })
+    {
+        if (_viewScales[side] <= 0)
+            return false;
+        visible |= _views[side];
+        scale = qMax(scale, _viewScales[side]);
+    }
+
+    // Contours are at y = -h * height
+    qreal height = -geometry.outline->minY();
+    if (height <= 0)
+        return false;
+    qreal heightPx = height * scale;
+
+    qreal baseTolerance = _contourTolerance * HI_TOL_FACTOR;
+    qreal previewFactor = fastCalc ? LOW_TOL_FACTOR / HI_TOL_FACTOR : 1;
+    detail->tolerance = qBound(baseTolerance / 16, previewFactor * MAX_SCREEN_ERROR / heightPx, baseTolerance * 16);
+    detail->resolution = size_t(qBound(qreal(MIN_VIEW_RES), heightPx / previewFactor, qreal(4 * HI_RES)));
+
+    qreal marginHeight = margin * visible.height();
+    detail->hMin = qMax(qreal(0), -(visible.bottom() + marginHeight) / height);
+    detail->hMax = qMin(qreal(1), -(visible.top() - marginHeight) / height);
+    return true;
+}
+
 void FoilCalculator::calculate(bool fastCalc)
 {
-    _topContours.clear();
-    _botContours.clear();
+    calculate(fastCalc, false);
+}
 
-    size_t sectionCount = fastCalc? LOW_SEC : HI_SEC;
-    size_t resolution = fastCalc? LOW_RES : HI_RES;
+void FoilCalculator::calculateFull()
+{
+    calculate(false, true);
+}
 
-    auto outline = decorate<PathScaleDecorator>(_foil->outline()->path(),1,-1);
-    auto topThickness = decorate<PathScaleDecorator>(_foil->thicknessProfile()->topProfile(),1,-1);
-    auto topProfile = decorate<PathScaleDecorator>(_foil->profile()->topProfile(),1,-1);
+// One calculation on a snapshot, planned on the calling thread and run in the background
+struct FoilCalculator::Calculation
+{
+    quint64 generation;
+    // When calculate() was called [ns]
+    int64_t requested;
+    bool fastCalc;
+    // Full fidelity results only stored in the caches, never shown
+    bool fill;
+    std::shared_ptr<const FoilGeometry> geometry;
+    Detail detail;
+    // Results are stored under cacheKey in cache once calculated
+    std::shared_ptr<ContourCache> cache;
+    QByteArray cacheKey;
+
+    // A lookup of the full fidelity results in cache instead of a calculation, see finish().
+    // It restores them when found and the view needs no finer detail than they have.
+    bool lookup;
+    QList<qreal> contourThicknesses;
+    bool viewed;
+    Detail viewDetail;
+    QByteArray key;
+    bool cached;
+    bool restored;
+
+    QList<std::shared_ptr<const ContourPolyline> > topContours;
+    QList<std::shared_ptr<const ContourPolyline> > botContours;
+    // Built by run() for shown release results
+    std::shared_ptr<const ContourBands> topBands;
+    std::shared_ptr<const ContourBands> botBands;
+
+    // Levels missing from the level cache, filled in by run()
+    struct Level { qreal specificPerc; Side::e side; std::shared_ptr<ContourPolyline> path; };
+    std::vector<Level> levels;
+
+    // Either reused or calculated by run()
+    std::shared_ptr<const AreaSweepCalculator> areaSweep;
+    std::shared_ptr<AreaSweepCalculator> aCalc;
+
+    void run();
+    bool restore();
+    void calculateContours();
+};
 
-    qreal thicknessRatio = _foil->profile()->thicknessRatio();
-#ifdef SERIAL
-    foreach (qreal thickness, _contourThicknesses)
+void FoilCalculator::calculate(bool fastCalc, bool full)
+{
+    // Calculate once when the running change transaction ends
+    if (_foil->inTransaction())
+    {
+        _foil->notifyReleased();
+        return;
+    }
+
+    // Any calculation supersedes a pending drag or view update
+    _frameTimer.stop();
+    _viewTimer.stop();
+    _lastCalculation.start();
+
+    // A single drag preview runs at a time, the latest geometry is calculated when it is done
+    if (fastCalc && _previewRunning)
+    {
+        _previewPending = true;
+        return;
+    }
+    _previewPending = false;
+
+    hrlib::instrument::Zone zone(s_calculateTimer);
+
+    // The calculation only reads the snapshot, never the live paths being edited
+    std::shared_ptr<const FoilGeometry> geometry = _foil->snapshot();
+
+    Detail detail = { _contourTolerance * (fastCalc? LOW_TOL_FACTOR : HI_TOL_FACTOR),
+                      fastCalc? LOW_RES : HI_RES, 0, 1 };
+    Detail fullDetail = detail;
+    bool viewed = !full && viewDetail(*geometry, fastCalc, VIEW_MARGIN, &detail);
+    _calculatedDetail = detail;
+
+    // Reopening an unchanged design restores the release results without calculating.
+    // The cache is looked up in the background, finish() calculates on a miss.
+    if (!fastCalc && _contourCache)
     {
-        if (inProfileSide(thickness, Side::Top))
+        std::shared_ptr<Calculation> lookup = std::make_shared<Calculation>();
+        lookup->generation = ++_generation;
+        lookup->requested = hrlib::instrument::now();
+        lookup->fastCalc = false;
+        lookup->fill = false;
+        lookup->geometry = geometry;
+        lookup->detail = fullDetail;
+        lookup->cache = _contourCache;
+        lookup->lookup = true;
+        lookup->contourThicknesses = _contourThicknesses;
+        lookup->viewed = viewed;
+        lookup->viewDetail = detail;
+        lookup->cached = lookup->restored = false;
+        _requested = lookup->generation;
+        start(lookup);
+        return;
+    }
+
+    std::shared_ptr<Calculation> calculation = plan(geometry, detail, fastCalc);
+    if (!fastCalc)
+        _requested = calculation->generation;
+    start(calculation);
+}
+
+void FoilCalculator::finish(std::shared_ptr<Calculation> calculation)
+{
+    if (!calculation->lookup || calculation->restored)
+    {
+        if (calculation->restored && calculation->generation == _requested)
+            _calculatedDetail = calculation->detail;
+        apply(*calculation);
+        return;
+    }
+
+    // A newer release calculation was requested meanwhile
+    if (calculation->generation != _requested)
+        return;
+
+    // Only full fidelity results are stored, they serve any view needing no finer detail.
+    // View limited results are not, the full fidelity ones are calculated for the cache
+    // in the background instead.
+    std::shared_ptr<Calculation> calculated;
+    if (calculation->viewed)
+    {
+        if (!calculation->cached && !_filling)
         {
-            qreal specificPerc = -_foil->profile()->pxThickness() * (thickness - 1)/_foil->profile()->topProfileTop().y() + 1;
-            std::shared_ptr<QPainterPath> topPath(new QPainterPath());
-            _topContours.append(topPath);
-            std::unique_ptr<invQPainterPath> path(new invQPainterPath(topPath.get()));
-            ContourCalculator<invQPainterPath> tcCalc(path.get(), specificPerc,
-                                                      outline.get(),
-                                                      topThickness.get(),
-                                                      topProfile.get(),
-                                                      _foil->thicknessProfile()->aspectRatioEnforced(),
-                                                      sectionCount, resolution);
-            tcCalc.run();
+            std::shared_ptr<Calculation> fill = plan(calculation->geometry, calculation->detail, false);
+            fill->fill = true;
+            fill->cache = calculation->cache;
+            fill->cacheKey = calculation->key;
+            start(fill);
         }
+        calculated = plan(calculation->geometry, calculation->viewDetail, false);
+    }
+    else
+    {
+        calculated = plan(calculation->geometry, calculation->detail, false);
+        calculated->cache = calculation->cache;
+        calculated->cacheKey = calculation->key;
+    }
+    calculated->requested = calculation->requested;
+    _requested = calculated->generation;
+    start(calculated);
+}
 
-        if (inProfileSide(thickness, Side::Bottom))
+std::shared_ptr<FoilCalculator::Calculation> FoilCalculator::plan(std::shared_ptr<const FoilGeometry> geometry,
+                                                                  const Detail &detail, bool fastCalc)
+{
+    std::shared_ptr<Calculation> calculation = std::make_shared<Calculation>();
+    calculation->generation = ++_generation;
+    calculation->requested = hrlib::instrument::now();
+    calculation->fastCalc = fastCalc;
+    calculation->fill = false;
+    calculation->geometry = geometry;
+    calculation->detail = detail;
+    calculation->lookup = false;
+    calculation->cached = calculation->restored = false;
+
+    qreal tolerance = detail.tolerance;
+    size_t resolution = detail.resolution;
+    qreal thicknessRatio = geometry->thicknessRatio;
+    bool arEnforced = geometry->aspectRatioEnforced;
+
+    // A symmetric profile mirrors the top profile and thickness into the bottom ones,
+    // which then equal the (y-inverted) top paths used here. A bottom contour is then
+    // the top contour with the same specific percentage, e.g. bottom(t) == top(1-t).
+    bool symmetric = geometry->symmetry == Profile::Symmetric && qFuzzyCompare(thicknessRatio, 1);
+    QList<QPair<qreal, std::shared_ptr<const ContourPolyline>>> symmetricContours;
+
+    // Release contours of unchanged levels are reused, only new levels are calculated.
+    // Drag previews are on ever changing geometry and would only evict them.
+    auto findLevel = [&](qreal specificPerc, Side::e side) -> const std::shared_ptr<const ContourPolyline>*
+    {
+        if (side == Side::Top)
+            return _levels.find(geometry->outline, geometry->topThickness, geometry->topProfile,
+                                arEnforced, tolerance, resolution, detail.hMin, detail.hMax, side, specificPerc);
+        return _levels.find(geometry->outline, geometry->botThickness, geometry->botProfile,
+                            arEnforced, tolerance, resolution, detail.hMin, detail.hMax, side, specificPerc);
+    };
+
+    auto contour = [&](qreal specificPerc, Side::e side) -> std::shared_ptr<const ContourPolyline>
+    {
+        if (symmetric)
         {
-            qreal specificPerc = -(_foil->profile()->pxThickness() * (thickness - 1)/_foil->profile()->bottomProfileTop().y() + thicknessRatio);
-            std::shared_ptr<QPainterPath> botPath(new QPainterPath());
-            _botContours.push_front(botPath);
-            std::unique_ptr<invQPainterPath> path(new invQPainterPath(botPath.get()));
-            ContourCalculator<invQPainterPath> bcCalc(path.get(), specificPerc,
-                                                      outline.get(),
-                                                      _foil->thicknessProfile()->botProfile(),
-                                                      _foil->profile()->botProfile(),
-                                                      _foil->thicknessProfile()->aspectRatioEnforced(),
-                                                      sectionCount, resolution);
-            bcCalc.run();
+            side = Side::Top;
+            for (const auto &calculated : symmetricContours)
+                if (qAbs(calculated.first - specificPerc) < 1e-9)
+                    return calculated.second;
         }
 
-        AreaSweepCalculator aCalc(_foil);
+        if (!fastCalc)
+            if (const std::shared_ptr<const ContourPolyline> *cached = findLevel(specificPerc, side))
+            {
+                if (symmetric)
+                    symmetricContours.append(qMakePair(specificPerc, *cached));
+                return *cached;
+            }
+
+        std::shared_ptr<ContourPolyline> contourPath(new ContourPolyline());
+        calculation->levels.push_back({ specificPerc, side, contourPath });
+
+        if (symmetric)
+            symmetricContours.append(qMakePair(specificPerc, contourPath));
+        return contourPath;
+    };
 
-        aCalc.run();
-    }
-#endif
-#ifndef SERIAL
-    std::list<std::unique_ptr<invQPainterPath>> painterscope;
     foreach (qreal thickness, _contourThicknesses)
     {
-        if (inProfileSide(thickness, Side::Top))
+        if (inProfileSide(*geometry, thickness, Side::Top))
         {
-            qreal specificPerc = -_foil->profile()->pxThickness() * (thickness - 1)/_foil->profile()->topProfileTop().y() + 1;
-            std::shared_ptr<QPainterPath> topPath(new QPainterPath());
-            _topContours.append(topPath);
-            std::unique_ptr<invQPainterPath> path(new invQPainterPath(topPath.get()));
-            _tPool.start(new ContourCalculator<invQPainterPath>(path.get(), specificPerc,
-                                                                outline.get(),
-                                                                topThickness.get(),
-                                                                topProfile.get(),
-                                                                _foil->thicknessProfile()->aspectRatioEnforced(),
-                                                                sectionCount, resolution));
-            painterscope.push_back(std::move(path));
+            qreal specificPerc = -geometry->pxThickness * (thickness - 1)/geometry->topProfileTop.y() + 1;
+            calculation->topContours.append(contour(specificPerc, Side::Top));
         }
 
-        if (inProfileSide(thickness, Side::Bottom))
+        if (inProfileSide(*geometry, thickness, Side::Bottom))
         {
-            qreal specificPerc = -(_foil->profile()->pxThickness() * (thickness - 1)/_foil->profile()->bottomProfileTop().y() + thicknessRatio);
-            std::shared_ptr<QPainterPath> botPath(new QPainterPath());
-            _botContours.push_front(botPath);
-            std::unique_ptr<invQPainterPath> path(new invQPainterPath(botPath.get()));
-            _tPool.start(new ContourCalculator<invQPainterPath>(path.get(), specificPerc,
-                                                                outline.get(),
-                                                                _foil->thicknessProfile()->botProfile(),
-                                                                _foil->profile()->botProfile(),
-                                                                _foil->thicknessProfile()->aspectRatioEnforced(),
-                                                                sectionCount, resolution));
-            painterscope.push_back(std::move(path));
+            qreal specificPerc = -(geometry->pxThickness * (thickness - 1)/geometry->bottomProfileTop.y() + thicknessRatio);
+            calculation->botContours.push_front(contour(specificPerc, Side::Bottom));
         }
     }
 
-    _tPool.start(new AreaSweepCalculator(_foil));
+    // Area and sweep only depend on the outline, and on the profile when the aspect ratio is enforced
+    std::shared_ptr<const PathSnapshot> arTop = arEnforced ? geometry->topProfile : nullptr;
+    std::shared_ptr<const PathSnapshot> arBot = arEnforced ? geometry->botProfile : nullptr;
+    if (auto cached = _areaSweep.find(geometry->outline, geometry->outlineHeight, arEnforced, arTop, arBot))
+        calculation->areaSweep = *cached;
+    else
+        calculation->aCalc = std::make_shared<AreaSweepCalculator>(geometry);
+
+    return calculation;
+}
 
-    _tPool.waitForDone();
+void FoilCalculator::start(std::shared_ptr<Calculation> calculation)
+{
+#ifdef SERIAL
+    calculation->run();
+    finish(calculation);
+#else
+    // Results are delivered queued to the calling thread, see onCalculationFinished()
+    if (calculation->fastCalc)
+        _previewRunning = true;
+    if (calculation->fill)
+        _filling = true;
+    _running.insert(calculation->generation, calculation);
+
+    // Drag previews take precedence over release-quality calculations, filling the cache comes last
+    Priority::e priority = calculation->fastCalc? Priority::Interactive :
+                           calculation->fill? Priority::Background : Priority::Release;
+    _tasks.run([this, calculation]() {
+        calculation->run();
+        emit calculationFinished(calculation->generation);
+    }, priority);
 #endif
+}
+
+void FoilCalculator::Calculation::run()
+{
+    if (lookup)
+    {
+        if (!restore())
+            return;
+    }
+    else
+    {
+        calculateContours();
+    }
+
+    // Release results are painted as non-overlapping bands. Building them takes boolean
+    // operations on the contours, which are done here instead of while painting.
+    if (!fastCalc && !fill)
+    {
+        hrlib::instrument::Zone bandsZone(s_bandsTimer);
+        qreal tolerance = detail.tolerance * -geometry->outline->minY(); // [scene units]
+        topBands = std::make_shared<const ContourBands>(bandContours(topContours, tolerance));
+        botBands = std::make_shared<const ContourBands>(bandContours(botContours, tolerance));
+    }
+
+    // Stored once the contours are final
+    if (cache && !cacheKey.isEmpty())
+    {
+        const AreaSweepCalculator &results = aCalc ? *aCalc : *areaSweep;
+        ContourCache::Entry entry = { topContours, botContours, results.area().value(),
+                                      results.sweep().value(), results.thickness() };
+        cache->store(cacheKey, entry);
+    }
+}
+
+bool FoilCalculator::Calculation::restore()
+{
+    key = ContourCache::key(*geometry, contourThicknesses, detail.tolerance, detail.resolution);
+    ContourCache::Entry entry;
+    cached = cache->load(key, &entry);
+    restored = cached && (!viewed || (viewDetail.tolerance >= detail.tolerance &&
+                                      viewDetail.resolution <= detail.resolution));
+    if (!restored)
+        return false;
+
+    topContours = entry.topContours;
+    botContours = entry.botContours;
+    areaSweep = std::make_shared<const AreaSweepCalculator>(
+                geometry, entry.area * si::square_meter, entry.sweep * si::radian, entry.thickness);
+    return true;
+}
+
+void FoilCalculator::Calculation::calculateContours()
+{
+    auto outline = geometry->outline->scaled(1,-1);
+    auto topThickness = geometry->topThickness->scaled(1,-1);
+    auto topProfile = geometry->topProfile->scaled(1,-1);
+    auto botThickness = geometry->botThickness;
+    auto botProfile = geometry->botProfile;
+    bool arEnforced = geometry->aspectRatioEnforced;
+
+    bool top = false, bot = false;
+    for (const Level &level : levels)
+        (level.side == Side::Top ? top : bot) = true;
+
+    // The coarse sections only depend on the outline and thickness, share them between all contours
+    hrlib::instrument::Zone sectionsZone(s_sectionsTimer);
+    std::shared_ptr<const std::vector<qreal>> topSections, botSections;
+    std::shared_ptr<const ThicknessLookup> topThicknessLookup, botThicknessLookup;
+    if (top)
+    {
+        topSections = std::make_shared<const std::vector<qreal>>(
+                    ContourCalculator<invPolyline>::initialSections(outline.get(), topThickness.get(), arEnforced));
+        topThicknessLookup = std::make_shared<const ThicknessLookup>(topThickness.get());
+    }
+    if (bot)
+    {
+        botSections = std::make_shared<const std::vector<qreal>>(
+                    ContourCalculator<invPolyline>::initialSections(outline.get(), botThickness.get(), arEnforced));
+        botThicknessLookup = std::make_shared<const ThicknessLookup>(botThickness.get());
+    }
+    sectionsZone.end();
+
+    std::list<std::unique_ptr<invPolyline>> painterscope;
+    std::vector<std::unique_ptr<ContourCalculator<invPolyline>>> calcs;
+    for (const Level &level : levels)
+    {
+        std::unique_ptr<invPolyline> path(new invPolyline(level.path.get()));
+        ContourCalculator<invPolyline> *calc;
+        if (level.side == Side::Top)
+            calc = new ContourCalculator<invPolyline>(path.get(), level.specificPerc,
+                                                          outline.get(),
+                                                          topThickness.get(),
+                                                          topProfile.get(),
+                                                          arEnforced,
+                                                          detail.tolerance, detail.resolution,
+                                                          topSections, topThicknessLookup);
+        else
+            calc = new ContourCalculator<invPolyline>(path.get(), level.specificPerc,
+                                                          outline.get(),
+                                                          botThickness.get(),
+                                                          botProfile.get(),
+                                                          arEnforced,
+                                                          detail.tolerance, detail.resolution,
+                                                          botSections, botThicknessLookup);
+        calc->setRefinedRange(detail.hMin, detail.hMax);
+        calcs.push_back(std::unique_ptr<ContourCalculator<invPolyline>>(calc));
+        painterscope.push_back(std::move(path));
+    }
+
+    hrlib::instrument::Zone contoursZone(s_contoursTimer);
+#ifdef SERIAL
+    for (auto &calc : calcs)
+        calc->run();
+
+    if (aCalc)
+        aCalc->run();
+#else
+    Priority::e priority = fastCalc? Priority::Interactive : fill? Priority::Background : Priority::Release;
+    TaskGroup tasks;
+
+    // With fewer levels than cores a single level would keep one core busy while
+    // the others idle, split the sections of each level in chunks instead.
+    // Oversplit to balance the uneven refinement between sections.
+    size_t threads = Scheduler::instance().threadCount();
+    size_t sectionChunks = calcs.empty() || calcs.size() >= threads ? 1 : 4 * threads / calcs.size();
+
+    for (auto &calc : calcs)
+    {
+        calc->setSectionChunks(sectionChunks, priority);
+        ContourCalculator<invPolyline> *c = calc.get();
+        tasks.run([c]() { c->run(); }, priority);
+    }
+
+    std::shared_ptr<AreaSweepCalculator> a = aCalc;
+    if (a)
+        tasks.run([a]() { a->run(); }, priority);
+
+    // Runs the queued tasks of this calculation meanwhile
+    tasks.wait();
+#endif
+
+    contoursZone.end();
+
+    // The calculated points are final, release the spare capacity
+    for (const auto &path : painterscope)
+        path->_p->squeeze();
+}
+
+void FoilCalculator::apply(Calculation &calculation)
+{
+    const FoilGeometry &geometry = *calculation.geometry;
+    const Detail &detail = calculation.detail;
+    bool arEnforced = geometry.aspectRatioEnforced;
+
+    // Release results remain valid for their snapshot, even when superseded
+    if (!calculation.fastCalc)
+        for (const Calculation::Level &level : calculation.levels)
+        {
+            if (level.side == Side::Top)
+                _levels.store(level.path, geometry.outline, geometry.topThickness, geometry.topProfile, arEnforced,
+                              detail.tolerance, detail.resolution, detail.hMin, detail.hMax, level.side, level.specificPerc);
+            else
+                _levels.store(level.path, geometry.outline, geometry.botThickness, geometry.botProfile, arEnforced,
+                              detail.tolerance, detail.resolution, detail.hMin, detail.hMax, level.side, level.specificPerc);
+        }
+
+    if (calculation.aCalc)
+    {
+        std::shared_ptr<const PathSnapshot> arTop = arEnforced ? geometry.topProfile : nullptr;
+        std::shared_ptr<const PathSnapshot> arBot = arEnforced ? geometry.botProfile : nullptr;
+        calculation.areaSweep = _areaSweep.store(calculation.aCalc, geometry.outline, geometry.outlineHeight,
+                                                 arEnforced, arTop, arBot);
+    }
+
+    // Results older than the shown ones are stale
+    if (calculation.fill || calculation.generation <= _appliedGeneration)
+        return;
+    _appliedGeneration = calculation.generation;
+    // Restored results were not calculated
+    if (!calculation.restored && hrlib::instrument::enabled())
+        s_calculationsTimer.record(hrlib::instrument::now() - calculation.requested);
+
+    _topContours = calculation.topContours;
+    _botContours = calculation.botContours;
+    _topBands = calculation.topBands;
+    _botBands = calculation.botBands;
+
+    // Results are written to the foil on the calling thread
+    calculation.areaSweep->apply(_foil);
 
     _calculated = true;
     emit foilCalculated(this);
 }
 
+void FoilCalculator::wait()
+{
+    while (!_running.isEmpty())
+    {
+        _tasks.wait();
+
+        // Delivered here, the queued notifications find nothing left.
+        // Delivering may start a pending drag preview, waited for in the next round.
+        for (quint64 generation : _running.keys())
+            onCalculationFinished(generation);
+    }
+}
+
+FoilCalculator::~FoilCalculator()
+{
+    // The running calculations notify this
+    _tasks.wait();
+}
+
 bool FoilCalculator::calculated() const
 {
     return _calculated;
@@ -215,17 +783,15 @@ void FoilCalculator::recalculateArea()
     aCalc.run();
 }
 
-bool FoilCalculator::inProfileSide(qreal thicknessPercent, Side::e side)
+bool FoilCalculator::inProfileSide(const FoilGeometry &geometry, qreal thicknessPercent, Side::e side)
 {
-    Profile* profile = _foil->profile();
-
     switch (side) {
     case Side::Bottom:
-        if (thicknessPercent - (profile->bottomProfileTop().y()-profile->botProfile()->minY())/profile->pxThickness() < 0.1)
+        if (thicknessPercent - (geometry.bottomProfileTop.y()-geometry.botProfileMinY)/geometry.pxThickness < 0.1)
             return true;
         return false;
     default:
-        if ((profile->bottomProfileTop().y()-profile->topProfile()->maxY())/profile->pxThickness() - thicknessPercent < 0.1)
+        if ((geometry.bottomProfileTop.y()-geometry.topProfileMaxY)/geometry.pxThickness - thicknessPercent < 0.1)
             return true;
         return false;
     }
@@ -233,7 +799,14 @@ bool FoilCalculator::inProfileSide(qreal thicknessPercent, Side::e side)
 
 void FoilCalculator::foilChanged()
 {
-    calculate(true);
+    // Previews start from the event loop, a release notified meanwhile supersedes them.
+    // Within a frame of the last calculation, only calculate the latest geometry once the frame ends.
+    int delay = 0;
+    if (_frameInterval > 0 && _lastCalculation.isValid() && _lastCalculation.elapsed() < _frameInterval)
+        delay = int(_frameInterval - _lastCalculation.elapsed());
+
+    if (!_frameTimer.isActive())
+        _frameTimer.start(delay);
 }
 
 void FoilCalculator::foilReleased()
@@ -241,10 +814,51 @@ void FoilCalculator::foilReleased()
     calculate(false);
 }
 
+void FoilCalculator::onFrame()
+{
+    calculate(true);
+}
 
-AreaSweepCalculator::AreaSweepCalculator(Foil *foil)
+void FoilCalculator::onViewChanged()
+{
+    calculate(false);
+}
+
+void FoilCalculator::onCalculationFinished(quint64 generation)
+{
+    auto it = _running.find(generation);
+    if (it == _running.end())
+        return;
+    std::shared_ptr<Calculation> calculation = *it;
+    _running.erase(it);
+
+    if (calculation->fastCalc)
+        _previewRunning = false;
+    if (calculation->fill)
+        _filling = false;
+    finish(calculation);
+
+    if (_previewPending)
+        calculate(true);
+}
+
+
+AreaSweepCalculator::AreaSweepCalculator(Foil *foil) :
+    _foil(foil), _thickness(0)
+{
+}
+
+AreaSweepCalculator::AreaSweepCalculator(std::shared_ptr<const FoilGeometry> geometry) :
+    _foil(nullptr), _geometry(geometry), _thickness(0)
+{
+}
+
+AreaSweepCalculator::AreaSweepCalculator(std::shared_ptr<const FoilGeometry> geometry,
+                                         quantity<si::area, qreal> area,
+                                         quantity<si::plane_angle, qreal> sweep,
+                                         qreal thickness) :
+    _foil(nullptr), _geometry(geometry), _area(area), _sweep(sweep), _thickness(thickness)
 {
-    _foil = foil;
 }
 
 
@@ -255,9 +869,48 @@ BOOST_GEOMETRY_REGISTER_POINT_2D_GET_SET(QPointF, qreal, cs::cartesian, x, y, se
 
 void AreaSweepCalculator::run()
 {
-    Path* outlinePath = _foil->outline()->path();
+    hrlib::instrument::Zone zone(s_areaSweepTimer);
+
+    // A calculator on a live foil updates it in place
+    if (_foil)
+        _geometry = _foil->snapshot();
+
+    calculate(*_geometry);
+
+    if (_foil)
+        apply(_foil);
+}
+
+void AreaSweepCalculator::apply(Foil *foil) const
+{
+    foil->outline()->setArea(_area);
+    foil->outline()->setSweep(_sweep);
+
+    // recalc thickness if AR enforced
+    if (_geometry->aspectRatioEnforced)
+      foil->pSetThickness(_thickness);
+}
+
+quantity<si::area, qreal> AreaSweepCalculator::area() const
+{
+    return _area;
+}
+
+quantity<si::plane_angle, qreal> AreaSweepCalculator::sweep() const
+{
+    return _sweep;
+}
+
+qreal AreaSweepCalculator::thickness() const
+{
+    return _thickness;
+}
+
+void AreaSweepCalculator::calculate(const FoilGeometry &geometry)
+{
+    const PathSnapshot *outlinePath = geometry.outline.get();
     qreal outlineTop = outlinePath->minY();
-    qreal scalefactor = qPow(_foil->outline()->height().value() / qAbs(outlineTop), 2);
+    qreal scalefactor = qPow(geometry.outlineHeight / qAbs(outlineTop), 2);
 
     const int resolution = 512;
     qreal percStep = 1 / qreal(resolution-1);
@@ -272,26 +925,26 @@ void AreaSweepCalculator::run()
 
     // calculate the area
     qreal smArea = std::abs(boost::geometry::area(points)) * scalefactor;
-    quantity<si::area, qreal> area = quantity<si::area, qreal>(smArea * si::square_meter);
-    _foil->outline()->setArea(area);
+    _area = quantity<si::area, qreal>(smArea * si::square_meter);
 
     // calculate the sweep angle
     QPointF centroid;
     boost::geometry::centroid(points, centroid);
-    qreal xHalfBase = _foil->outline()->path()->pointAtPercent(1).x()/2;
+    qreal xHalfBase = outlinePath->pointAtPercent(1).x()/2;
     qreal os = centroid.x() - xHalfBase;
     qreal ns = -centroid.y();
-    quantity<si::plane_angle, qreal> sweep(qAtan(os/ns) * si::radian);
-    _foil->outline()->setSweep(sweep);
+    _sweep = quantity<si::plane_angle, qreal>(qAtan(os/ns) * si::radian);
 
-    // recalc thickness if AR enforced
-    if (_foil->aspectRatioEnforced()) {
+    // thickness following the aspect ratio of the profile
+    if (geometry.aspectRatioEnforced) {
       // TODO recalc on depth change
-      auto topProfile = _foil->profile()->topProfile();
-      auto botProfile = _foil->profile()->botProfile();
+      auto topProfile = geometry.topProfile;
+      auto botProfile = geometry.botProfile;
       auto aspectRatio = (botProfile->maxY() - topProfile->minY()) /
         (topProfile->pointAtPercent(1).x() - topProfile->pointAtPercent(0).x());
-      auto thickness = (_foil->outlineSI()->pointAtPercent(1).x() - _foil->outlineSI()->pointAtPercent(0).x())*aspectRatio;
-      _foil->pSetThickness(thickness);
+      // scaling of Foil::outlineSI()
+      qreal t_top = 0.3;
+      qreal s = geometry.outlineHeight / -outlinePath->minY(&t_top);
+      _thickness = (outlinePath->pointAtPercent(1).x() - outlinePath->pointAtPercent(0).x())*s*aspectRatio;
     }
 }
@@ -29,6 +29,7 @@
 #include "hrlib/curvefit/curvefit.hpp"
 #include "hrlib/io/vertexio.hpp"
 #include "hrlib/io/pdfio.hpp"
+#include "hrlib/instrument/instrument.hpp"
 #include "foillogic/profile.hpp"
 #include "foillogic/outline.hpp"
 #include "patheditor/path.hpp"
@@ -46,6 +47,9 @@ namespace {
   const double OUTLINE_HEIGHT_PX = 260;
   auto comp_x = [](const vertex<2> &v1, const vertex<2> &v2){ return v1[0] < v2[0]; };
   auto comp_y = [](const vertex<2> &v1, const vertex<2> &v2){ return v1[1] < v2[1]; };
+
+  hrlib::instrument::Timer s_profileDatTimer("loadProfileDatStream");
+  hrlib::instrument::Timer s_outlinePdfTimer("loadOutlinePdfStream");
 }
 
 namespace foillogic {
@@ -88,6 +92,7 @@ std::array<std::vector<vertex<2>>,2> foillogic::parse_profile(std::istream &stre
 
 Profile* foillogic::loadProfileDatStream(std::istream &stream)
 {
+  hrlib::instrument::Zone zone(s_profileDatTimer);
   const double scale = 300;
 
   auto dat_curves = parse_profile(stream, scale);
@@ -245,6 +250,7 @@ namespace {
 
 Outline* foillogic::loadOutlinePdfStream(std::istream &stream, std::ostream */*err*/)
 {
+  hrlib::instrument::Zone zone(s_outlinePdfTimer);
   std::unique_ptr<Outline> outline(new Outline());
 
   // Parse a sequence of path commands (first path encountered)
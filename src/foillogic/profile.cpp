@@ -23,6 +23,7 @@
 #include "foillogic/profile.hpp"
 
 #include "patheditor/path.hpp"
+#include "patheditor/pathsnapshot.hpp"
 #include "patheditor/controlpoint.hpp"
 #include "patheditor/curvepoint.hpp"
 #include "patheditor/pointrestrictor.hpp"
@@ -43,10 +44,13 @@ namespace {
     Editable = 0x1,
     Default = Editable
   }; };
+
+  DerivedCounter s_profileTopCounter("Profile::profileTop");
 }
 
 Profile::Profile(QObject *parent) :
     QObject(parent), _symmetry(Symmetry::Symmetric),
+    _topProfileTop(s_profileTopCounter), _botProfileTop(s_profileTopCounter),
     t_topProfileTop(0.3), t_botProfileTop(0.3), _flags(Flags::Default)
 {
     initProfile();
@@ -74,6 +78,8 @@ Profile::Symmetry Profile::symmetry() const
 
 void Profile::setSymmetry(Symmetry symmetry)
 {
+    // Restricting and mirroring the bottom points notifies once, when all moved
+    Path::ChangeTransaction transaction(_topProfile.get());
     _symmetry = symmetry;
 
     if (_symmetry == Symmetry::Flat)
@@ -96,40 +102,52 @@ void Profile::setSymmetry(Symmetry symmetry)
         }
     }
 
-    onProfileChanged(_topProfile.get());
-    onProfileReleased();
+    _topProfile->onPathChanged();
+    _topProfile->onPathReleased();
     emit symmetryChanged(_symmetry);
 }
 
 QPointF Profile::topProfileTop(qreal *t_top) const
 {
-    if (t_top) *t_top = t_topProfileTop;
-    return _topProfileTop;
+    const ProfileTop &top = _topProfileTop.get([this]() {
+        _topProfile->minY(&t_topProfileTop);
+        return ProfileTop{ _topProfile->pointAtPercent(t_topProfileTop), t_topProfileTop };
+    }, _topProfile->snapshot());
+
+    if (t_top) *t_top = top.t;
+    return top.point;
 }
 
 QPointF Profile::bottomProfileTop(qreal *t_top) const
 {
-    if (t_top) *t_top = t_botProfileTop;
-    return _botProfileTop;
+    const ProfileTop &top = _botProfileTop.get([this]() {
+        _botProfile->maxY(&t_botProfileTop);
+        return ProfileTop{ _botProfile->pointAtPercent(t_botProfileTop), t_botProfileTop };
+    }, _botProfile->snapshot());
+
+    if (t_top) *t_top = top.t;
+    return top.point;
 }
 
 qreal Profile::pxThickness() const
 {
-    return _botProfileTop.y() - _topProfileTop.y();
+    return bottomProfileTop().y() - topProfileTop().y();
 }
 
 qreal Profile::thicknessRatio() const
 {
-    if (_topProfileTop.y() == 0)
+    qreal top = topProfileTop().y(), bot = bottomProfileTop().y();
+    if (top == 0)
         return 0.0000001;
-    if (_botProfileTop.y() == 0)
+    if (bot == 0)
         return 9999999;
-    return -_topProfileTop.y() / _botProfileTop.y();
+    return -top / bot;
 }
 
 qreal Profile::topRatio() const
 {
-    return -_topProfileTop.y() / (-_topProfileTop.y() + _botProfileTop.y());
+    qreal top = topProfileTop().y(), bot = bottomProfileTop().y();
+    return -top / (-top + bot);
 }
 
 bool Profile::editable() const
@@ -351,11 +369,6 @@ void Profile::onProfileChanged(Path* path)
         }
     }
 
-    _topProfile->minY(&t_topProfileTop);
-    _botProfile->maxY(&t_botProfileTop);
-    _topProfileTop = _topProfile->pointAtPercent(t_topProfileTop);
-    _botProfileTop = _botProfile->pointAtPercent(t_botProfileTop);
-
     emit profileChanged(this);
 }
 
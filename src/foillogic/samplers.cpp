@@ -22,66 +22,243 @@
 
 #include "foillogic/samplers.hpp"
 
-#include <boost/math/tools/roots.hpp>
+#include <queue>
+#include <cmath>
+#include <algorithm>
 #include "foillogic/profile.hpp"
 #include "patheditor/path.hpp"
 
 using namespace foillogic;
 using namespace patheditor;
-using namespace boost::math;
 
 namespace {
-  typedef boost::math::policies::policy<boost::math::policies::evaluation_error<boost::math::policies::ignore_error>> ignore_eval_err;
-  const std::function<bool(qreal,qreal)> stop_condition = [](qreal a, qreal b){return std::abs(a-b) < 0.0001;};
+  inline qreal polyVal(const qreal c[4], qreal t)
+  {
+    return ((c[3]*t + c[2])*t + c[1])*t + c[0];
+  }
+
+  // Real roots of a*t^3 + b*t^2 + c*t + d, returns the number of roots
+  int cubicRoots(qreal a, qreal b, qreal c, qreal d, qreal roots[3])
+  {
+    const qreal eps = 1e-12;
+    qreal scale = std::max({std::abs(a), std::abs(b), std::abs(c)});
+    if (scale == 0)
+      return 0;
+
+    if (std::abs(a) < eps*scale)
+      {
+        if (std::abs(b) < eps*scale)
+          {
+            roots[0] = -d/c;
+            return 1;
+          }
+
+        qreal disc = c*c - 4*b*d;
+        if (disc < 0)
+          return 0;
+        // avoid cancellation, see Numerical Recipes 5.6
+        qreal q = -0.5*(c + std::copysign(std::sqrt(disc), c));
+        if (q == 0)
+          {
+            roots[0] = 0;
+            return 1;
+          }
+        roots[0] = q/b;
+        roots[1] = d/q;
+        return 2;
+      }
+
+    qreal B = b/a, C = c/a, D = d/a;
+    qreal Q = (B*B - 3*C)/9;
+    qreal R = (2*B*B*B - 9*B*C + 27*D)/54;
+    qreal Q3 = Q*Q*Q;
+    if (R*R < Q3)
+      {
+        qreal theta = std::acos(R/std::sqrt(Q3));
+        qreal sqrtQ = std::sqrt(Q);
+        roots[0] = -2*sqrtQ*std::cos(theta/3) - B/3;
+        roots[1] = -2*sqrtQ*std::cos((theta + 2*M_PI)/3) - B/3;
+        roots[2] = -2*sqrtQ*std::cos((theta - 2*M_PI)/3) - B/3;
+        return 3;
+      }
+
+    qreal A = -std::copysign(std::cbrt(std::abs(R) + std::sqrt(R*R - Q3)), R);
+    roots[0] = A + (A != 0 ? Q/A : 0) - B/3;
+    return 1;
+  }
 }
 
-FeatureSampler::FeatureSampler() { _featureSamples.push_back(0); }
+FeatureSampler::FeatureSampler(qreal tolerance) :
+  _tolerance(tolerance), _streams(1, std::vector<qreal>(1, 0)), _merged(false) {}
 
 void FeatureSampler::addFeatureSamples(const IPath *path, std::function<qreal(QPointF)> getter, size_t sample_rate)
 {
+  std::vector<qreal> stream;
+  stream.reserve(sample_rate);
   for (size_t i=0; i<sample_rate; i++)
-    _featureSamples.push_back(
+    stream.push_back(
       // start at i+1 to avoid 0 duplication
       // divide by sample_rate+2 to avoid 1 duplication
       getter(path->pointAtPercent(qreal(i+1)/qreal(sample_rate+2)))
           );
+  std::sort(stream.begin(), stream.end());
+
+  _streams.push_back(std::move(stream));
+  _merged = false;
 }
 
 void FeatureSampler::addUniformSamples(double min, double max, size_t cnt)
 {
+  std::vector<qreal> stream;
+  stream.reserve(cnt);
+  // by index, accumulating the increment drifts
   double increment = (max-min)/double(cnt);
-  for (double v=min; v<max; v+=increment)
-    _featureSamples.push_back(v);
+  for (size_t i=0; i<cnt; i++)
+    stream.push_back(min + i*increment);
+
+  _streams.push_back(std::move(stream));
+  _merged = false;
+}
+
+void FeatureSampler::merge()
+{
+  // k-way merge of the sorted streams
+  typedef std::pair<qreal, size_t> Head; // value, stream index
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+  std::vector<size_t> positions(_streams.size(), 0);
+
+  size_t total = 0;
+  for (size_t i=0; i<_streams.size(); i++)
+    {
+      total += _streams[i].size();
+      if (!_streams[i].empty())
+        heads.push(Head(_streams[i][0], i));
+    }
+
+  _samples.clear();
+  _samples.reserve(total);
+  while (!heads.empty())
+    {
+      Head head = heads.top();
+      heads.pop();
+
+      if (_samples.empty() || head.first - _samples.back() > _tolerance)
+        _samples.push_back(head.first);
+
+      size_t &pos = positions[head.second];
+      if (++pos < _streams[head.second].size())
+        heads.push(Head(_streams[head.second][pos], head.second));
+    }
+
+  _merged = true;
+}
+
+const std::vector<qreal> &FeatureSampler::samples()
+{
+  if (!_merged)
+    merge();
+  return _samples;
 }
 
 std::vector<qreal> FeatureSampler::sampleAt(size_t resolution)
 {
-  // Sort and deduplicate the feature samples
-  std::sort(_featureSamples.begin(), _featureSamples.end());
-  _featureSamples.erase(std::unique(_featureSamples.begin(), _featureSamples.end()), _featureSamples.end());
-  // Subsample the feature samples at resolution
+  const std::vector<qreal> &merged = samples();
+  // Subsample the merged samples at resolution
   std::vector<qreal> sampled;
+  sampled.reserve(resolution);
   for (size_t i=0; i<resolution;i++)
     {
-      size_t idx = i*_featureSamples.size()/resolution;
-      sampled.push_back(_featureSamples[idx]);
+      size_t idx = i*merged.size()/resolution;
+      sampled.push_back(merged[idx]);
     }
   return sampled;
 }
 
-std::vector<qreal> foillogic::sampleThickess(const IPath *thicknessProfile, const std::vector<qreal> &sectionHeightArray)
+ThicknessLookup::ThicknessLookup(const IPath *thicknessProfile)
 {
-  std::vector<qreal> sampled(sectionHeightArray.size());
-  size_t i = 0;
-  for (qreal height : sectionHeightArray)
+  for (const std::vector<QPointF> &item : thicknessProfile->bezierItems())
     {
-      auto f_thickness = [=](qreal perc) -> qreal {
-          return thicknessProfile->pointAtPercent(perc).x()-height;
-        };
+      Segment segment;
+      const QPointF &p0 = item.front();
+      const QPointF &p3 = item.back();
+      if (item.size() == 4)
+        {
+          const QPointF &p1 = item[1];
+          const QPointF &p2 = item[2];
+          QPointF c1 = 3*(p1 - p0);
+          QPointF c2 = 3*(p0 - 2*p1 + p2);
+          QPointF c3 = p3 - 3*p2 + 3*p1 - p0;
+          segment.x[0] = p0.x(); segment.x[1] = c1.x(); segment.x[2] = c2.x(); segment.x[3] = c3.x();
+          segment.y[0] = p0.y(); segment.y[1] = c1.y(); segment.y[2] = c2.y(); segment.y[3] = c3.y();
+        }
+      else
+        {
+          segment.x[0] = p0.x(); segment.x[1] = p3.x() - p0.x(); segment.x[2] = 0; segment.x[3] = 0;
+          segment.y[0] = p0.y(); segment.y[1] = p3.y() - p0.y(); segment.y[2] = 0; segment.y[3] = 0;
+        }
+      segment.xEnd = p3.x();
+      _segments.push_back(segment);
+    }
+}
+
+qreal ThicknessLookup::thicknessAt(const Segment &segment, qreal height)
+{
+  // First root of x(t) - height in [0, 1]
+  qreal roots[3];
+  int rootCount = cubicRoots(segment.x[3], segment.x[2], segment.x[1], segment.x[0] - height, roots);
+
+  const qreal eps = 1e-9;
+  qreal t = -1;
+  for (int i=0; i<rootCount; i++)
+    if (roots[i] >= -eps && roots[i] <= 1+eps && (t < 0 || roots[i] < t))
+      t = roots[i];
+
+  if (t < 0)
+    // height outside the segment, use the nearest end
+    t = std::abs(segment.x[0] - height) < std::abs(segment.xEnd - height) ? 0 : 1;
+
+  return polyVal(segment.y, std::min(std::max(t, qreal(0)), qreal(1)));
+}
+
+qreal ThicknessLookup::thicknessAt(qreal height) const
+{
+  if (_segments.empty())
+    return 0;
+
+  auto it = std::lower_bound(_segments.begin(), _segments.end(), height,
+                             [](const Segment &s, qreal h){ return s.xEnd < h; });
+  if (it == _segments.end())
+    it--;
+  return thicknessAt(*it, height);
+}
+
+std::vector<qreal> ThicknessLookup::sample(const std::vector<qreal> &sortedHeights) const
+{
+  if (_segments.empty())
+    return std::vector<qreal>(sortedHeights.size(), 0);
+
+  std::vector<qreal> sampled;
+  sampled.reserve(sortedHeights.size());
 
-      boost::uintmax_t max_it = 50;
-      auto sol = tools::bisect(f_thickness, 0.0, 1.0, stop_condition, max_it, ignore_eval_err());
-      sampled[i++] = thicknessProfile->pointAtPercent(sol.first).y();
+  size_t j = 0;
+  for (qreal height : sortedHeights)
+    {
+      while (j < _segments.size()-1 && _segments[j].xEnd < height)
+        j++;
+      sampled.push_back(thicknessAt(_segments[j], height));
     }
   return sampled;
 }
+
+std::vector<qreal> foillogic::sampleThickess(const IPath *thicknessProfile, const std::vector<qreal> &sectionHeightArray)
+{
+  ThicknessLookup lookup(thicknessProfile);
+  if (std::is_sorted(sectionHeightArray.begin(), sectionHeightArray.end()))
+    return lookup.sample(sectionHeightArray);
+
+  std::vector<qreal> sampled;
+  sampled.reserve(sectionHeightArray.size());
+  for (qreal height : sectionHeightArray)
+    sampled.push_back(lookup.thicknessAt(height));
+  return sampled;
+}
@@ -0,0 +1,234 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "hrlib/concurrent/scheduler.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace hrlib::concurrent;
+
+namespace {
+  // Identifies the worker running on the current thread
+  thread_local const Scheduler *t_scheduler = nullptr;
+  thread_local size_t t_queue = 0;
+}
+
+Scheduler::Scheduler(unsigned threadCount) :
+  _queued(0), _stop(false)
+{
+  if (threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+  for (unsigned i=0; i<=threadCount; i++)
+    _queues.push_back(std::unique_ptr<Queue>(new Queue()));
+
+  for (unsigned i=1; i<=threadCount; i++)
+    _workers.push_back(std::thread(&Scheduler::workerLoop, this, i));
+}
+
+Scheduler &Scheduler::instance()
+{
+  static Scheduler scheduler([]() -> unsigned {
+      const char *threads = std::getenv("HRLIB_THREADS");
+      return threads ? unsigned(std::max(0, std::atoi(threads))) : 0;
+    }());
+  return scheduler;
+}
+
+unsigned Scheduler::threadCount() const
+{
+  return _workers.size();
+}
+
+void Scheduler::submit(Task task, Priority::e priority, TaskGroup *group)
+{
+  // Counted before a worker can start it, the group is not touched once it is
+  // queued: the task may be done and the group destroyed by then.
+  // A waiting group wakes up to help with it.
+  if (group)
+    {
+      group->_pending++;
+      group->_queued[priority]++;
+      group->submitted();
+    }
+
+  Queue &queue = *_queues[currentQueue()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.lanes[priority].push_back(Entry{std::move(task), group});
+  }
+  _queued++;
+
+  // Taking the lock orders the wake-up after a worker's check of _queued
+  { std::lock_guard<std::mutex> lock(_sleepMutex); }
+  _wake.notify_one();
+}
+
+Scheduler::~Scheduler()
+{
+  _stop = true;
+  { std::lock_guard<std::mutex> lock(_sleepMutex); }
+  _wake.notify_all();
+
+  for (std::thread &worker : _workers)
+    worker.join();
+}
+
+size_t Scheduler::currentQueue() const
+{
+  return t_scheduler == this ? t_queue : 0;
+}
+
+bool Scheduler::pop(Queue &queue, int lane, bool newest, Entry &entry)
+{
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  std::deque<Entry> &tasks = queue.lanes[lane];
+  if (tasks.empty())
+    return false;
+
+  if (newest)
+    {
+      entry = std::move(tasks.back());
+      tasks.pop_back();
+    }
+  else
+    {
+      entry = std::move(tasks.front());
+      tasks.pop_front();
+    }
+  return true;
+}
+
+bool Scheduler::runOne(size_t self, int maxLane)
+{
+  Entry entry;
+  bool found = false;
+
+  int lane = 0;
+  for (; lane<=maxLane; lane++)
+    {
+      // own tasks newest first, they are most likely still in cache
+      found = pop(*_queues[self], lane, self != 0, entry);
+
+      // injection queue and other workers oldest first
+      for (size_t i=1; i<_queues.size() && !found; i++)
+        found = pop(*_queues[(self + i) % _queues.size()], lane, false, entry);
+
+      if (found)
+        break;
+    }
+
+  if (!found)
+    return false;
+
+  _queued--;
+  if (entry.group)
+    entry.group->started(lane);
+  entry.task();
+  if (entry.group)
+    entry.group->finished();
+  return true;
+}
+
+void Scheduler::workerLoop(size_t self)
+{
+  t_scheduler = this;
+  t_queue = self;
+
+  while (true)
+    {
+      if (runOne(self, laneCount-1))
+        continue;
+
+      std::unique_lock<std::mutex> lock(_sleepMutex);
+      if (_stop && _queued == 0)
+        break;
+      _wake.wait(lock, [this]{ return _stop || _queued > 0; });
+    }
+}
+
+
+TaskGroup::TaskGroup(Scheduler &scheduler) :
+  _scheduler(scheduler), _pending(0)
+{
+  for (std::atomic<int> &queued : _queued)
+    queued = 0;
+}
+
+void TaskGroup::run(Scheduler::Task task, Priority::e priority)
+{
+  _scheduler.submit(std::move(task), priority, this);
+}
+
+void TaskGroup::wait()
+{
+  size_t self = _scheduler.currentQueue();
+  while (true)
+    {
+      // Only the lanes of the queued tasks of this group, a group that
+      // queued Background tasks before does not run them for others now
+      int lane = queuedLane();
+      if (_pending > 0 && lane >= 0 && _scheduler.runOne(self, lane))
+        continue;
+
+      // Only return while holding the lock, finished() may still be
+      // notifying otherwise.
+      // The remaining tasks are running on other threads, submitting or
+      // finishing a task of this group wakes the wait.
+      std::unique_lock<std::mutex> lock(_mutex);
+      _changed.wait(lock, [this]{ return _pending == 0 || queuedLane() >= 0; });
+      if (_pending == 0)
+        return;
+    }
+}
+
+int TaskGroup::queuedLane() const
+{
+  for (int lane=Scheduler::laneCount-1; lane>=0; lane--)
+    if (_queued[lane] > 0)
+      return lane;
+  return -1;
+}
+
+void TaskGroup::submitted()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _changed.notify_all();
+}
+
+void TaskGroup::started(int lane)
+{
+  _queued[lane]--;
+}
+
+TaskGroup::~TaskGroup()
+{
+  wait();
+}
+
+void TaskGroup::finished()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (--_pending == 0)
+    _changed.notify_all();
+}
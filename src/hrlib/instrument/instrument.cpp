@@ -0,0 +1,274 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "hrlib/instrument/instrument.hpp"
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+using namespace hrlib::instrument;
+
+namespace {
+  // Bound on the events kept per thread, later events are dropped
+  const size_t MAX_TRACE_EVENTS = 1 << 18;
+
+  std::atomic<bool> s_enabled(false);
+  std::atomic<bool> s_tracing(false);
+  std::atomic<int64_t> s_traceStart(0);
+  std::atomic<uint32_t> s_threadCount(0);
+
+  std::mutex &registryMutex()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  std::vector<Timer*> &registry()
+  {
+    static std::vector<Timer*> timers;
+    return timers;
+  }
+
+  std::vector<Counter*> &counterRegistry()
+  {
+    static std::vector<Counter*> counters;
+    return counters;
+  }
+
+  struct TraceEvent
+  {
+    const char *name;
+    char phase;    // 'X' complete zone, 'C' counter
+    int64_t ts;    // [ns]
+    int64_t value; // duration [ns] or counter value
+  };
+
+  // Only the owning thread appends, the mutex guards against
+  // a concurrent start or write from another thread
+  struct TraceBuffer
+  {
+    std::mutex mutex;
+    uint32_t tid;
+    std::vector<TraceEvent> events;
+    size_t dropped = 0;
+  };
+
+  // Buffers outlive their threads, so the events of finished
+  // worker threads end up in the trace
+  std::vector<std::shared_ptr<TraceBuffer>> &traceBuffers()
+  {
+    static std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    return buffers;
+  }
+
+  TraceBuffer &threadBuffer()
+  {
+    thread_local std::shared_ptr<TraceBuffer> buffer;
+    if (!buffer)
+    {
+      buffer = std::make_shared<TraceBuffer>();
+      buffer->tid = threadId();
+      std::lock_guard<std::mutex> lock(registryMutex());
+      traceBuffers().push_back(buffer);
+    }
+    return *buffer;
+  }
+
+  void append(const TraceEvent &event)
+  {
+    TraceBuffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < MAX_TRACE_EVENTS)
+      buffer.events.push_back(event);
+    else
+      buffer.dropped++;
+  }
+
+  void writeString(std::ostream &out, const char *str)
+  {
+    out << '"';
+    for (; *str; str++)
+    {
+      if (*str == '"' || *str == '\\')
+        out << '\\';
+      out << *str;
+    }
+    out << '"';
+  }
+
+  // Trace-event timestamps are in microseconds
+  void writeMicroseconds(std::ostream &out, int64_t ns)
+  {
+    if (ns < 0)
+    {
+      out << '-';
+      ns = -ns;
+    }
+    int64_t frac = ns % 1000;
+    out << ns / 1000 << '.' << char('0' + frac/100) << char('0' + frac/10%10) << char('0' + frac%10);
+  }
+}
+
+bool hrlib::instrument::enabled()
+{
+  return s_enabled.load(std::memory_order_relaxed);
+}
+
+void hrlib::instrument::setEnabled(bool enabled)
+{
+  s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool hrlib::instrument::tracing()
+{
+  return s_tracing.load(std::memory_order_relaxed);
+}
+
+void hrlib::instrument::startTracing()
+{
+  stopTracing();
+
+  std::vector<std::shared_ptr<TraceBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    buffers = traceBuffers();
+  }
+  for (auto &buffer : buffers)
+  {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->events.clear();
+    buffer->dropped = 0;
+  }
+
+  s_traceStart.store(now(), std::memory_order_relaxed);
+  s_tracing.store(true, std::memory_order_relaxed);
+}
+
+void hrlib::instrument::stopTracing()
+{
+  s_tracing.store(false, std::memory_order_relaxed);
+}
+
+bool hrlib::instrument::writeChromeTrace(std::ostream &out)
+{
+  std::vector<std::shared_ptr<TraceBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    buffers = traceBuffers();
+  }
+  int64_t start = s_traceStart.load(std::memory_order_relaxed);
+
+  size_t dropped = 0;
+  const char *separator = "\n";
+  out << "{\"traceEvents\":[";
+  for (auto &buffer : buffers)
+  {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    dropped += buffer->dropped;
+    for (const TraceEvent &event : buffer->events)
+    {
+      out << separator << "{\"name\":";
+      writeString(out, event.name);
+      out << ",\"ph\":\"" << event.phase << "\",\"ts\":";
+      writeMicroseconds(out, event.ts - start);
+      if (event.phase == 'X')
+      {
+        out << ",\"dur\":";
+        writeMicroseconds(out, event.value);
+      }
+      out << ",\"pid\":1,\"tid\":" << buffer->tid;
+      if (event.phase == 'C')
+        out << ",\"args\":{\"value\":" << event.value << "}";
+      out << "}";
+      separator = ",\n";
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+
+  return out.good();
+}
+
+uint32_t hrlib::instrument::threadId()
+{
+  thread_local uint32_t id = s_threadCount.fetch_add(1, std::memory_order_relaxed) + 1;
+  return id;
+}
+
+void hrlib::instrument::traceZone(const char *name, int64_t start, int64_t end)
+{
+  append({ name, 'X', start, end - start });
+}
+
+void hrlib::instrument::traceCounter(const char *name, int64_t value)
+{
+  append({ name, 'C', now(), value });
+}
+
+Timer::Timer(const char *name) :
+  _name(name), _count(0), _total(0), _max(0)
+{
+  std::lock_guard<std::mutex> lock(registryMutex());
+  registry().push_back(this);
+}
+
+void Timer::record(int64_t ns)
+{
+  _count.fetch_add(1, std::memory_order_relaxed);
+  _total.fetch_add(ns, std::memory_order_relaxed);
+
+  int64_t max = _max.load(std::memory_order_relaxed);
+  while (ns > max && !_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+}
+
+Timer::Stats Timer::stats() const
+{
+  return { _count.load(std::memory_order_relaxed),
+           _total.load(std::memory_order_relaxed),
+           _max.load(std::memory_order_relaxed) };
+}
+
+Timer::Stats Timer::take()
+{
+  return { _count.exchange(0, std::memory_order_relaxed),
+           _total.exchange(0, std::memory_order_relaxed),
+           _max.exchange(0, std::memory_order_relaxed) };
+}
+
+std::vector<Timer*> Timer::all()
+{
+  std::lock_guard<std::mutex> lock(registryMutex());
+  return registry();
+}
+
+Counter::Counter(const char *name) :
+  _name(name), _value(0)
+{
+  std::lock_guard<std::mutex> lock(registryMutex());
+  counterRegistry().push_back(this);
+}
+
+std::vector<Counter*> Counter::all()
+{
+  std::lock_guard<std::mutex> lock(registryMutex());
+  return counterRegistry();
+}
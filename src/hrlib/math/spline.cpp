@@ -21,22 +21,6 @@ using namespace std;
 namespace hrlib
 {
 
-template<typename T>
-class ArrayIterator : public std::iterator<std::random_access_iterator_tag, T>
-{
-  T* p;
-public:
-  ArrayIterator(T* x) :p(x) {}
-  ArrayIterator(const ArrayIterator& mit) : p(mit.p) {}
-  ArrayIterator& operator++() {++p;return *this;}
-  ArrayIterator& operator--() {--p;return *this;}
-  ArrayIterator& operator+=(int i) {p+=i;return *this;}
-  bool operator==(const ArrayIterator& rhs) {return p==rhs.p;}
-  bool operator!=(const ArrayIterator& rhs) {return p!=rhs.p;}
-  int operator-(const ArrayIterator& rhs) {return p-rhs.p;}
-  T& operator*() {return *p;}
-};
-
 //****************************************************************************80
 
 void r8vec_bracket ( int n, qreal x[], qreal xval, int *left,
@@ -68,6 +52,8 @@ void r8vec_bracket ( int n, qreal x[], qreal xval, int *left,
 //    C++ to use 0-based values.
 //
 //    2014/11/20 Hans Robeers: Reimplemented using std::upper_bound O(log2(n))
+//    2026/10/18 Hans Robeers: Search plain pointers, the ArrayIterator
+//      version failed to compile on MSVC 2017.
 //
 //  Licensing:
 //
@@ -77,6 +63,7 @@ void r8vec_bracket ( int n, qreal x[], qreal xval, int *left,
 //
 //    24 February 2004
 //    20 November 2014
+//    18 October 2026
 //
 //  Author:
 //
@@ -93,39 +80,95 @@ void r8vec_bracket ( int n, qreal x[], qreal xval, int *left,
 //
 //    Output, int *LEFT, *RIGHT, the results of the search.
 //
-/* TODO MSVC 2017 fails to compile the upper_bound version
 {
-  ArrayIterator<qreal> begin(x), end(x+n);
-  auto it = std::upper_bound(begin, end, xval);
-  *left = it - begin;
-  if (xval / *left == 1.0) *left += 1;
-  if (*left == 0) *left = 1;
-  else if (*left == n) *left = n-1;
+  *left = static_cast<int> ( std::upper_bound ( x + 1, x + n - 1, xval ) - x );
   *right = *left + 1;
+
+  return;
 }
-*/
+//****************************************************************************80
+
+void r8vec_bracket ( int n, qreal x[], qreal xval, int *left,
+  int *right, r8vec_bracket_cursor *cursor )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    R8VEC_BRACKET searches a sorted array for successive brackets of a value,
+//    starting from the interval found by the previous search.
+//
+//  Discussion:
+//
+//    The results are identical to those of R8VEC_BRACKET without a cursor.
+//
+//    The cursor remembers the last interval.  If XVAL lies in that interval,
+//    or in the next one, no search is needed, so a sequence of increasing
+//    values is bracketed in O(1) per value.  Otherwise the binary search
+//    is used and the cursor is reset to its result.
+//
+//    A cursor belongs to a single array X; it is not thread safe.
+//
+//  Licensing:
+//
+//    This code is distributed under the GNU LGPL license.
+//
+//  Modified:
+//
+//    18 October 2026
+//
+//  Author:
+//
+//    Hans Robeers
+//
+//  Parameters:
+//
+//    Input, int N, length of input array.
+//
+//    Input, qreal X[N], an array that has been sorted into ascending order.
+//
+//    Input, qreal XVAL, a value to be bracketed.
+//
+//    Output, int *LEFT, *RIGHT, the results of the search.
+//
+//    Input/output, r8vec_bracket_cursor *CURSOR, the interval of the
+//    previous search.  If CURSOR is null, a binary search is used.
+//
 {
   int i;
 
-  for ( i = 2; i <= n - 1; i++ )
+  if ( cursor == 0 )
   {
-    if ( xval < x[i-1] )
+    r8vec_bracket ( n, x, xval, left, right );
+    return;
+  }
+
+  i = cursor->left;
+
+  if ( 1 <= i && i <= n - 1 && ( i == 1 || x[i-1] <= xval ) )
+  {
+    if ( i < n - 1 && x[i] <= xval )
     {
-      *left = i - 1;
-      *right = i;
+      i = i + 1;
+    }
+    if ( i == n - 1 || xval < x[i] )
+    {
+      cursor->left = i;
+      *left = i;
+      *right = i + 1;
       return;
     }
+  }
 
-   }
-
-  *left = n - 1;
-  *right = n;
+  r8vec_bracket ( n, x, xval, left, right );
+  cursor->left = *left;
 
   return;
 }
 //****************************************************************************80
 
-qreal basis_function_b_val ( qreal tdata[], qreal tval )
+qreal basis_function_b_val ( qreal tdata[], qreal tval,
+  r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -175,6 +218,9 @@ qreal basis_function_b_val ( qreal tdata[], qreal tval )
 //
 //    Output, qreal BASIS_FUNCTION_B_VAL, the value of the function at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
 # define NDATA 5
 
@@ -191,7 +237,7 @@ qreal basis_function_b_val ( qreal tdata[], qreal tval )
 //
 //  Find the interval [ TDATA(LEFT), TDATA(RIGHT) ] containing TVAL.
 //
-  r8vec_bracket ( NDATA, tdata, tval, &left, &right );
+  r8vec_bracket ( NDATA, tdata, tval, &left, &right, cursor );
 //
 //  U is the normalized coordinate of TVAL in this interval.
 //
@@ -236,7 +282,7 @@ qreal basis_function_b_val ( qreal tdata[], qreal tval )
 //****************************************************************************80
 
 qreal basis_function_beta_val ( qreal beta1, qreal beta2, qreal tdata[],
-  qreal tval )
+  qreal tval, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -295,6 +341,9 @@ qreal basis_function_beta_val ( qreal beta1, qreal beta2, qreal tdata[],
 //
 //    Output, qreal BASIS_FUNCTION_BETA_VAL, the value of the function at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
 # define NDATA 5
 
@@ -315,7 +364,7 @@ qreal basis_function_beta_val ( qreal beta1, qreal beta2, qreal tdata[],
 //
 //  Find the interval [ TDATA(LEFT), TDATA(RIGHT) ] containing TVAL.
 //
-  r8vec_bracket ( NDATA, tdata, tval, &left, &right );
+  r8vec_bracket ( NDATA, tdata, tval, &left, &right, cursor );
 //
 //  U is the normalized coordinate of TVAL in this interval.
 //
@@ -4285,7 +4334,8 @@ qreal spline_b_val_impl ( int ndata, qreal u, int idxLeft, int idxRight, qreal y
 }
 //****************************************************************************80
 
-qreal spline_b_val ( int ndata, qreal tdata[], qreal ydata[], qreal tval )
+qreal spline_b_val ( int ndata, qreal tdata[], qreal ydata[], qreal tval,
+  r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -4332,6 +4382,9 @@ qreal spline_b_val ( int ndata, qreal tdata[], qreal ydata[], qreal tval )
 //
 //    Output, qreal SPLINE_B_VAL, the value of the function at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   int left;
   int right;
@@ -4339,7 +4392,7 @@ qreal spline_b_val ( int ndata, qreal tdata[], qreal ydata[], qreal tval )
   //
   //  Find the nearest interval [ TDATA(LEFT), TDATA(RIGHT) ] to TVAL.
   //
-  r8vec_bracket ( ndata, tdata, tval, &left, &right );
+  r8vec_bracket ( ndata, tdata, tval, &left, &right, cursor );
   //
   //  Evaluate the 5 nonzero B spline basis functions in the interval,
   //  weighted by their corresponding data values.
@@ -4409,8 +4462,105 @@ qreal spline_b_val ( int ndata, qreal ydata[], qreal tval )
 }
 //****************************************************************************80
 
+void spline_b_val_batch ( int ndata, qreal xdata[], qreal ydata[],
+  qreal tstart, qreal tstep, int nval, qreal xval[], qreal yval[] )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    SPLINE_B_VAL_BATCH evaluates a 2D cubic B spline approximant at
+//    NVAL equally spaced parameter values.
+//
+//  Discussion:
+//
+//    The result equals calling SPLINE_B_VAL ( NDATA, XDATA, TVAL ) and
+//    SPLINE_B_VAL ( NDATA, YDATA, TVAL ) for TVAL = TSTART + I * TSTEP,
+//    but since TVAL increases monotonically, the interval is advanced
+//    instead of searched, the control values (including the phantom
+//    nodes) are fetched once per interval, and the basis functions are
+//    evaluated once per point for both coordinates.
+//
+//  Licensing:
+//
+//    This code is distributed under the GNU LGPL license.
+//
+//  Modified:
+//
+//    18 October 2026
+//
+//  Author:
+//
+//    Hans Robeers
+//
+//  Parameters:
+//
+//    Input, int NDATA, the number of data values, at least 2.
+//
+//    Input, qreal XDATA[NDATA], YDATA[NDATA], the data values.
+//
+//    Input, qreal TSTART, the first parameter value, 0 <= TSTART <= ndata.
+//
+//    Input, qreal TSTEP, the parameter increment, 0 <= TSTEP.
+//
+//    Input, int NVAL, the number of values to evaluate.
+//
+//    Output, qreal XVAL[NVAL], YVAL[NVAL], the values of the spline.
+//
+{
+  int left = 0;
+  qreal cx[4];
+  qreal cy[4];
+
+  for ( int i = 0; i < nval; i++ )
+  {
+    qreal tval = tstart + i * tstep;
+    //
+    //  Advance to the nearest interval to TVAL and refresh the control values.
+    //
+    int next = left;
+    if ( left == 0 )
+    {
+      next = 1;
+    }
+    while ( next < ndata - 1 && next <= tval )
+    {
+      next++;
+    }
+
+    if ( next != left )
+    {
+      left = next;
+
+      cx[0] = ( 0 < left-1 ) ? xdata[left-2] : 2.0 * xdata[0] - xdata[1];
+      cy[0] = ( 0 < left-1 ) ? ydata[left-2] : 2.0 * ydata[0] - ydata[1];
+      cx[1] = xdata[left-1];
+      cy[1] = ydata[left-1];
+      cx[2] = xdata[left];
+      cy[2] = ydata[left];
+      cx[3] = ( left+2 <= ndata ) ? xdata[left+1] : 2.0 * xdata[ndata-1] - xdata[ndata-2];
+      cy[3] = ( left+2 <= ndata ) ? ydata[left+1] : 2.0 * ydata[ndata-1] - ydata[ndata-2];
+    }
+    //
+    //  Evaluate the 4 nonzero B spline basis functions once for both coordinates.
+    //
+    qreal u = tval + 1 - left;
+    qreal b[4];
+    b[0] = ( ( ( - 1.0 * u + 3.0 ) * u - 3.0 ) * u + 1.0 ) / 6.0;
+    b[1] = ( ( (   3.0 * u - 6.0 ) * u + 0.0 ) * u + 4.0 ) / 6.0;
+    b[2] = ( ( ( - 3.0 * u + 3.0 ) * u + 3.0 ) * u + 1.0 ) / 6.0;
+    b[3] = boost::math::pow<3>( u ) / 6.0;
+
+    xval[i] = cx[0] * b[0] + cx[1] * b[1] + cx[2] * b[2] + cx[3] * b[3];
+    yval[i] = cy[0] * b[0] + cy[1] * b[1] + cy[2] * b[2] + cy[3] * b[3];
+  }
+
+  return;
+}
+//****************************************************************************80
+
 qreal spline_beta_val ( qreal beta1, qreal beta2, int ndata, qreal tdata[],
-  qreal ydata[], qreal tval )
+  qreal ydata[], qreal tval, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -4462,6 +4612,9 @@ qreal spline_beta_val ( qreal beta1, qreal beta2, int ndata, qreal tdata[],
 //
 //    Output, qreal SPLINE_BETA_VAL, the value of the function at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   qreal a;
   qreal b;
@@ -4476,7 +4629,7 @@ qreal spline_beta_val ( qreal beta1, qreal beta2, int ndata, qreal tdata[],
 //
 //  Find the nearest interval [ TDATA(LEFT), TDATA(RIGHT) ] to TVAL.
 //
-  r8vec_bracket ( ndata, tdata, tval, &left, &right );
+  r8vec_bracket ( ndata, tdata, tval, &left, &right, cursor );
 //
 //  Evaluate the 5 nonzero beta spline basis functions in the interval,
 //  weighted by their corresponding data values.
@@ -4559,7 +4712,7 @@ qreal spline_beta_val ( qreal beta1, qreal beta2, int ndata, qreal tdata[],
 //****************************************************************************80
 
 qreal spline_constant_val ( int ndata, qreal tdata[], qreal ydata[],
-  qreal tval )
+  qreal tval, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -4600,18 +4753,43 @@ qreal spline_constant_val ( int ndata, qreal tdata[], qreal ydata[],
 //
 //    Output, qreal *SPLINE_CONSTANT_VAL, the value of the spline at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   int i;
-
-  for ( i = 0; i < ndata-1; i++ )
+//
+//  Try the interval of the previous call, and the next one.
+//  The cursor stores the 1-based index of the interval.
+//
+  if ( cursor != 0 )
   {
-    if ( tval <= tdata[i] )
+    i = cursor->left - 1;
+
+    if ( 0 <= i && i <= ndata - 1 && ( i == 0 || tdata[i-1] < tval ) )
     {
-      return ydata[i];
+      if ( i < ndata - 1 && tdata[i] < tval )
+      {
+        i = i + 1;
+      }
+      if ( i == ndata - 1 || tval <= tdata[i] )
+      {
+        cursor->left = i + 1;
+        return ydata[i];
+      }
     }
   }
+//
+//  Find the first breakpoint not below TVAL.
+//
+  i = static_cast<int> ( std::lower_bound ( tdata, tdata + ndata - 1, tval ) - tdata );
 
-  return ydata[ndata-1];
+  if ( cursor != 0 )
+  {
+    cursor->left = i + 1;
+  }
+
+  return ydata[i];
 }
 //****************************************************************************80
 
@@ -4868,7 +5046,7 @@ qreal *spline_cubic_set ( int n, qreal t[], qreal y[], int ibcbeg,
 //****************************************************************************80
 
 qreal spline_cubic_val ( int n, qreal t[], qreal y[], qreal ypp[],
-  qreal tval, qreal *ypval, qreal *yppval )
+  qreal tval, qreal *ypval, qreal *yppval, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -4928,26 +5106,22 @@ qreal spline_cubic_val ( int n, qreal t[], qreal y[], qreal ypp[],
 //
 //    Output, qreal SPLINE_VAL, the value of the spline at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   qreal dt;
   qreal h;
-  int i;
   int ival;
+  int left;
+  int right;
   qreal yval;
 //
 //  Determine the interval [ T(I), T(I+1) ] that contains TVAL.
 //  Values below T[0] or above T[N-1] use extrapolation.
 //
-  ival = n - 2;
-
-  for ( i = 0; i < n-1; i++ )
-  {
-    if ( tval < t[i+1] )
-    {
-      ival = i;
-      break;
-    }
-  }
+  r8vec_bracket ( n, t, tval, &left, &right, cursor );
+  ival = left - 1;
 //
 //  In the interval I, the polynomial is in terms of a normalized
 //  coordinate between 0 and 1.
@@ -5173,7 +5347,7 @@ qreal *spline_hermite_set ( int ndata, qreal tdata[], qreal ydata[],
 //****************************************************************************80
 
 void spline_hermite_val ( int ndata, qreal tdata[], qreal c[], qreal tval,
-  qreal *sval, qreal *spval )
+  qreal *sval, qreal *spval, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -5239,6 +5413,9 @@ void spline_hermite_val ( int ndata, qreal tdata[], qreal c[], qreal tval,
 //    Output, qreal *SVAL, *SPVAL, the value of the interpolant
 //    and its derivative at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   qreal dt;
   int left;
@@ -5247,7 +5424,7 @@ void spline_hermite_val ( int ndata, qreal tdata[], qreal c[], qreal tval,
 //  Find the interval [ TDATA(LEFT), TDATA(RIGHT) ] that contains
 //  or is nearest to TVAL.
 //
-  r8vec_bracket ( ndata, tdata, tval, &left, &right );
+  r8vec_bracket ( ndata, tdata, tval, &left, &right, cursor );
 //
 //  Evaluate the cubic polynomial.
 //
@@ -5267,7 +5444,7 @@ void spline_hermite_val ( int ndata, qreal tdata[], qreal c[], qreal tval,
 //****************************************************************************80
 
 qreal spline_linear_int ( int ndata, qreal tdata[], qreal ydata[],
-  qreal a, qreal b )
+  qreal a, qreal b, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -5299,6 +5476,9 @@ qreal spline_linear_int ( int ndata, qreal tdata[], qreal ydata[],
 //
 //    Output, qreal SPLINE_LINEAR_INT, the value of the integral.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   qreal a_copy;
   int a_left;
@@ -5325,12 +5505,12 @@ qreal spline_linear_int ( int ndata, qreal tdata[], qreal ydata[],
 //  Find the interval [ TDATA(A_LEFT), TDATA(A_RIGHT) ] that contains, or is
 //  nearest to, A.
 //
-  r8vec_bracket ( ndata, tdata, a_copy, &a_left, &a_right );
+  r8vec_bracket ( ndata, tdata, a_copy, &a_left, &a_right, cursor );
 //
 //  Find the interval [ TDATA(B_LEFT), TDATA(B_RIGHT) ] that contains, or is
 //  nearest to, B.
 //
-  r8vec_bracket ( ndata, tdata, b_copy, &b_left, &b_right );
+  r8vec_bracket ( ndata, tdata, b_copy, &b_left, &b_right, cursor );
 //
 //  If A and B are in the same interval...
 //
@@ -5518,7 +5698,7 @@ void spline_linear_intset ( int n, qreal int_x[], qreal int_v[],
 //****************************************************************************80
 
 void spline_linear_val ( int ndata, qreal tdata[], qreal ydata[],
-  qreal tval, qreal *yval, qreal *ypval )
+  qreal tval, qreal *yval, qreal *ypval, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -5559,6 +5739,9 @@ void spline_linear_val ( int ndata, qreal tdata[], qreal ydata[],
 //    derivative dYdT at TVAL.  YPVAL is not reliable if TVAL is exactly
 //    equal to TDATA(I) for some I.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   int left;
   int right;
@@ -5566,7 +5749,7 @@ void spline_linear_val ( int ndata, qreal tdata[], qreal ydata[],
 //  Find the interval [ TDATA(LEFT), TDATA(RIGHT) ] that contains, or is
 //  nearest to, TVAL.
 //
-  r8vec_bracket ( ndata, tdata, tval, &left, &right );
+  r8vec_bracket ( ndata, tdata, tval, &left, &right, cursor );
 //
 //  Now evaluate the piecewise linear function.
 //
@@ -5580,7 +5763,7 @@ void spline_linear_val ( int ndata, qreal tdata[], qreal ydata[],
 //****************************************************************************80
 
 qreal spline_overhauser_nonuni_val ( int ndata, qreal tdata[],
-  qreal ydata[], qreal tval )
+  qreal ydata[], qreal tval, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -5625,6 +5808,9 @@ qreal spline_overhauser_nonuni_val ( int ndata, qreal tdata[],
 //    Output, qreal SPLINE_OVERHAUSER_NONUNI_VAL, the value of the
 //    spline at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   qreal alpha;
   qreal beta;
@@ -5648,7 +5834,7 @@ qreal spline_overhauser_nonuni_val ( int ndata, qreal tdata[],
 //
 //  Find the nearest interval [ TDATA(LEFT), TDATA(RIGHT) ] to TVAL.
 //
-  r8vec_bracket ( ndata, tdata, tval, &left, &right );
+  r8vec_bracket ( ndata, tdata, tval, &left, &right, cursor );
 //
 //  Evaluate the spline in the given interval.
 //
@@ -5715,7 +5901,7 @@ qreal spline_overhauser_nonuni_val ( int ndata, qreal tdata[],
 //****************************************************************************80
 
 qreal spline_overhauser_uni_val ( int ndata, qreal tdata[], qreal ydata[],
-  qreal tval )
+  qreal tval, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -5752,6 +5938,9 @@ qreal spline_overhauser_uni_val ( int ndata, qreal tdata[], qreal ydata[],
 //
 //    Output, qreal SPLINE_OVERHAUSER_UNI_VAL, the value of the spline at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   int left;
   qreal *mbasis;
@@ -5770,7 +5959,7 @@ qreal spline_overhauser_uni_val ( int ndata, qreal tdata[], qreal ydata[],
 //
 //  Find the nearest interval [ TDATA(LEFT), TDATA(RIGHT) ] to TVAL.
 //
-  r8vec_bracket ( ndata, tdata, tval, &left, &right );
+  r8vec_bracket ( ndata, tdata, tval, &left, &right, cursor );
 //
 //  Evaluate the spline in the given interval.
 //
@@ -5808,8 +5997,159 @@ qreal spline_overhauser_uni_val ( int ndata, qreal tdata[], qreal ydata[],
 }
 //****************************************************************************80
 
+void spline_overhauser_uni_val_batch ( int ndata, qreal tdata[], qreal xdata[],
+  qreal ydata[], qreal tstart, qreal tstep, int nval, qreal xval[], qreal yval[] )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    SPLINE_OVERHAUSER_UNI_VAL_BATCH evaluates a 2D uniform Overhauser spline
+//    at NVAL equally spaced parameter values.
+//
+//  Discussion:
+//
+//    The result equals calling SPLINE_OVERHAUSER_UNI_VAL for XDATA and YDATA
+//    at TVAL = TSTART + I * TSTEP.  Since TVAL increases monotonically, the
+//    interval is tracked by a bracketing cursor instead of searched, and
+//    the product of the basis matrix with the data values is computed once
+//    per interval, leaving a single Horner evaluation per point and
+//    coordinate.
+//
+//  Licensing:
+//
+//    This code is distributed under the GNU LGPL license.
+//
+//  Modified:
+//
+//    18 October 2026
+//
+//  Author:
+//
+//    Hans Robeers
+//
+//  Parameters:
+//
+//    Input, int NDATA, the number of data points.
+//    NDATA must be at least 3.
+//
+//    Input, qreal TDATA[NDATA], the abscissas of the data points.
+//    The values of TDATA are assumed to be uniformly spaced with an
+//    increment of 1.0.
+//
+//    Input, qreal XDATA[NDATA], YDATA[NDATA], the data values.
+//
+//    Input, qreal TSTART, the first parameter value.
+//
+//    Input, qreal TSTEP, the parameter increment, 0 <= TSTEP.
+//
+//    Input, int NVAL, the number of values to evaluate.
+//
+//    Output, qreal XVAL[NVAL], YVAL[NVAL], the values of the spline.
+//
+{
+  int left = 0;
+  int n = 0;
+  qreal cx[4];
+  qreal cy[4];
+  r8vec_bracket_cursor cursor;
+//
+//  Check NDATA.
+//
+  if ( ndata < 3 )
+  {
+    cerr << "\n";
+    cerr << "SPLINE_OVERHAUSER_UNI_VAL_BATCH - Fatal error!\n";
+    cerr << "  NDATA < 3.\n";
+    exit ( 1 );
+  }
+
+  qreal *mbasis_l = basis_matrix_overhauser_uni_l ( );
+  qreal *mbasis = basis_matrix_overhauser_uni ( );
+  qreal *mbasis_r = basis_matrix_overhauser_uni_r ( );
+
+  for ( int i = 0; i < nval; i++ )
+  {
+    qreal tval = tstart + i * tstep;
+    //
+    //  Advance to the nearest interval [ TDATA(LEFT), TDATA(LEFT+1) ] to TVAL.
+    //
+    int next;
+    int right;
+    r8vec_bracket ( ndata, tdata, tval, &next, &right, &cursor );
+    //
+    //  Compute the polynomial coefficients MBASIS * P for the new interval.
+    //
+    if ( next != left )
+    {
+      left = next;
+
+      qreal *m;
+      int first;
+      if ( left == 1 )
+      {
+        m = mbasis_l;
+        n = 3;
+        first = left;
+      }
+      else if ( left < ndata - 1 )
+      {
+        m = mbasis;
+        n = 4;
+        first = left - 1;
+      }
+      else
+      {
+        m = mbasis_r;
+        n = 3;
+        first = left - 1;
+      }
+
+      for ( int k = 0; k < n; k++ )
+      {
+        cx[k] = 0.0;
+        cy[k] = 0.0;
+        for ( int j = 0; j < n; j++ )
+        {
+          cx[k] = cx[k] + m[k+j*n] * xdata[first - 1 + j];
+          cy[k] = cy[k] + m[k+j*n] * ydata[first - 1 + j];
+        }
+      }
+    }
+
+    qreal arg;
+    if ( left == 1 )
+    {
+      arg = 0.5 * ( tval - tdata[left-1] );
+    }
+    else if ( left < ndata - 1 )
+    {
+      arg = tval - tdata[left-1];
+    }
+    else
+    {
+      arg = 0.5 * ( 1.0 + tval - tdata[left-1] );
+    }
+
+    xval[i] = cx[0];
+    yval[i] = cy[0];
+    for ( int k = 1; k < n; k++ )
+    {
+      xval[i] = xval[i] * arg + cx[k];
+      yval[i] = yval[i] * arg + cy[k];
+    }
+  }
+
+  delete [] mbasis_l;
+  delete [] mbasis;
+  delete [] mbasis_r;
+
+  return;
+}
+//****************************************************************************80
+
 void spline_overhauser_val ( int ndim, int ndata, qreal tdata[],
-  qreal ydata[], qreal tval, qreal yval[] )
+  qreal ydata[], qreal tval, qreal yval[], r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -5878,6 +6218,9 @@ void spline_overhauser_val ( int ndim, int ndata, qreal tdata[],
 //
 //    Output, qreal YVAL[NDIM], the value of the spline at TVAL.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   int i;
   int left;
@@ -5909,7 +6252,7 @@ void spline_overhauser_val ( int ndim, int ndata, qreal tdata[],
 //  Locate the abscissa interval T[LEFT], T[LEFT+1] nearest to or
 //  containing TVAL.
 //
-  r8vec_bracket ( ndata, tdata, tval, &left, &right );
+  r8vec_bracket ( ndata, tdata, tval, &left, &right, cursor );
 //
 //  Evaluate the "left hand" quadratic defined at
 //  T[LEFT-1], T[LEFT], T[RIGHT].
@@ -6480,7 +6823,7 @@ void spline_pchip_val ( int n, qreal x[], qreal f[], qreal d[],
 //****************************************************************************80
 
 void spline_quadratic_val ( int ndata, qreal tdata[], qreal ydata[],
-  qreal tval, qreal *yval, qreal *ypval )
+  qreal tval, qreal *yval, qreal *ypval, r8vec_bracket_cursor *cursor )
 
 //****************************************************************************80
 //
@@ -6522,6 +6865,9 @@ void spline_quadratic_val ( int ndata, qreal tdata[], qreal ydata[],
 //    derivative dYdT at TVAL.  YPVAL is not reliable if TVAL is exactly
 //    equal to TDATA(I) for some I.
 //
+//    Input/output, r8vec_bracket_cursor *CURSOR, an optional cursor kept
+//    by the caller across calls on the same knot vector, see R8VEC_BRACKET.
+//
 {
   qreal dif1;
   qreal dif2;
@@ -6553,7 +6899,7 @@ void spline_quadratic_val ( int ndata, qreal tdata[], qreal ydata[],
 //  Find the interval [ TDATA(LEFT), TDATA(RIGHT) ] that contains, or is
 //  nearest to, TVAL.
 //
-  r8vec_bracket ( ndata, tdata, tval, &left, &right );
+  r8vec_bracket ( ndata, tdata, tval, &left, &right, cursor );
 //
 //  Force LEFT to be odd.
 //
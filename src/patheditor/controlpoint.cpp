@@ -39,3 +39,8 @@ void ControlPoint::createPointHandleImpl(QGraphicsItem *parent, const PathSettin
     newPointHandle->setZValue(2);
     replaceCurrentPointHandle(newPointHandle);
 }
+
+const QBrush &ControlPoint::handleBrush(const PathSettings *settings) const
+{
+    return settings->controlPointBrush();
+}
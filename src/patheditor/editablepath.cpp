@@ -25,17 +25,28 @@
 #include <QPainter>
 #include <QGraphicsItem>
 #include <QGraphicsScene>
+#include <QTimer>
+#include <QWidget>
+#include "hrlib/instrument/instrument.hpp"
 #include "patheditor/path.hpp"
 #include "patheditor/pathitem.hpp"
 #include "patheditor/pathpoint.hpp"
 #include "patheditor/controlpoint.hpp"
 #include "patheditor/pointhandle.hpp"
+#include "patheditor/pointhandlepool.hpp"
+#include "patheditor/patheditorview.hpp"
 
 using namespace patheditor;
 
+namespace {
+    hrlib::instrument::Timer s_paintTimer("EditablePath::paint");
+}
+
 EditablePath::EditablePath(Path *path, const PathSettings* settings, bool editable, QGraphicsItem *parent)
-  : QGraphicsObject(parent), _editable(editable), _path(path), _settings(settings)
+  : QGraphicsObject(parent), _editable(editable), _path(path), _settings(settings),
+    _handles(new PointHandlePool(this, settings))
 {
+    _boundingRect = _path->controlPointRect();
     for (auto item : _path->pathItems())
         onAppend(item.get());
     connect(path, SIGNAL(onAppend(patheditor::PathItem*)), this, SLOT(onAppend(patheditor::PathItem*)), Qt::UniqueConnection);
@@ -43,15 +54,33 @@ EditablePath::EditablePath(Path *path, const PathSettings* settings, bool editab
 
 QRectF EditablePath::boundingRect() const
 {
-    return _path->controlPointRect();
+    return _boundingRect;
 }
 
-void EditablePath::paint(QPainter *painter, const QStyleOptionGraphicsItem* /*unused*/, QWidget* /*unused*/)
+void EditablePath::paint(QPainter *painter, const QStyleOptionGraphicsItem* /*unused*/, QWidget *widget)
 {
+    hrlib::instrument::Zone zone(s_paintTimer);
+
     if (isVisible())
     {
         _path->paint(painter, _editable, _settings);
 
+        if (_editable && !_handlesPending)
+        {
+            QRectF visible;
+            PathEditorView *view = widget ? dynamic_cast<PathEditorView*>(widget->parentWidget()) : nullptr;
+            if (view)
+                visible = mapRectFromScene(view->visibleSceneRect());
+
+            // Adding handles while painting would schedule another paint, sync afterwards
+            bool outside = !_handleRegion.isNull() && !visible.isNull() && !_handleRegion.contains(visible);
+            if (!_handlesValid || outside)
+            {
+                _handlesPending = true;
+                QTimer::singleShot(0, this, [this, visible]() { syncHandles(visible); });
+            }
+        }
+
         if (_firstPaint)
         {
             _firstPaint = false;
@@ -79,27 +108,86 @@ void EditablePath::setEditable(bool editable)
 {
     _editable = editable;
 
-    for (auto item : _path->pathItems())
+    if (editable)
     {
-        item->startPoint()->handle()->setVisible(editable);
-        item->endPoint()->handle()->setVisible(editable);
+        _handlesValid = false;
+        update();
+    }
+    else
+    {
+        syncHandles();
+    }
+}
 
-        for (auto point : item->controlPoints())
+bool EditablePath::editable()
+{
+    return _editable;
+}
+
+void EditablePath::syncHandles(const QRectF &visible)
+{
+    _handlesPending = false;
+    _handlesValid = true;
+    qreal dx = visible.width() / 2;
+    qreal dy = visible.height() / 2;
+    _handleRegion = visible.isNull() ? QRectF() : visible.adjusted(-dx, -dy, dx, dy);
+
+    QHash<PathPoint*, std::shared_ptr<PathPoint> > wanted;
+    auto want = [&](const std::shared_ptr<PathPoint> &point) {
+        if (_handleRegion.isNull() || _handleRegion.contains(*point))
+            wanted.insert(point.get(), point);
+    };
+    if (_editable)
+    {
+        for (auto item : _path->pathItems())
         {
-            point->handle()->setVisible(editable);
+            want(item->startPoint());
+            want(item->endPoint());
+            for (auto controlPoint : item->controlPoints())
+                want(controlPoint);
         }
     }
+
+    // Keep the handle being dragged, even when it left the region
+    QGraphicsItem *grabber = scene() ? scene()->mouseGrabberItem() : nullptr;
+    for (auto it = _attached.begin(); it != _attached.end();)
+    {
+        std::shared_ptr<PathPoint> point = it->point.lock();
+        if (point && (wanted.contains(it.key()) || it->handle == grabber))
+        {
+            ++it;
+            continue;
+        }
+
+        _handles->release(it->handle, point != nullptr);
+        it = _attached.erase(it);
+    }
+
+    for (auto point : wanted)
+    {
+        if (!_attached.contains(point.get()))
+            _attached.insert(point.get(), Attached{point, _handles->acquire(point.get())});
+    }
 }
 
-bool EditablePath::editable()
+const PointHandlePool *EditablePath::handlePool() const
 {
-    return _editable;
+    return _handles.get();
+}
+
+EditablePath::~EditablePath()
+{
+    // The handles are deleted as children of this item, detach them from the points outliving it
+    for (const Attached &attached : _attached)
+    {
+        std::shared_ptr<PathPoint> point = attached.point.lock();
+        if (point && point->handle() == attached.handle)
+            point->attachHandle(nullptr);
+    }
 }
 
 void EditablePath::onAppend(PathItem *pathItem)
 {
-    // Add the startpoint pointHandle
-    pathItem->startPoint()->createPointHandle(this, _settings);
     if (editable()) {
       connect(pathItem->startPoint().get(), SIGNAL(pointRemove(PathPoint*)),
               this, SLOT(onPointRemove(PathPoint*)), Qt::UniqueConnection);
@@ -109,16 +197,19 @@ void EditablePath::onAppend(PathItem *pathItem)
               this, SLOT(onPointPathTypeToggle(PathPoint*)), Qt::UniqueConnection);
     }
 
-    // Add the endpoint pointHandle
-    pathItem->endPoint()->createPointHandle(this, _settings);
+    // Point handles are attached at the next paint
+    _handlesValid = false;
+    update();
 
-    // Add the controlPoint's pointHandles
-    for (auto controlPoint : pathItem->controlPoints())
+    connectPoints(pathItem);
+
+    _itemRects[pathItem] = pathItem->controlPointRect();
+    QRectF rect = _path->controlPointRect();
+    if (rect != _boundingRect)
     {
-        controlPoint->createPointHandle(this, _settings);
+        prepareGeometryChange();
+        _boundingRect = rect;
     }
-
-    connectPoints(pathItem);
 }
 
 void EditablePath::onPointRemove(PathPoint *sender)
@@ -136,18 +227,18 @@ void EditablePath::onPointPathTypeToggle(PathPoint *sender)
   emit pointPathTypeToggle(sender, this);
 }
 
-void EditablePath::onPointDrag(PathPoint* /*unused*/)
+void EditablePath::onPointDrag(PathPoint *sender)
 {
     _released = false;
     emitPathChanged();
-    this->scene()->update();
+    updateAround(sender);
 }
 
-void EditablePath::onPointRelease(PathPoint* /*unused*/)
+void EditablePath::onPointRelease(PathPoint *sender)
 {
     _released = true;
     emitPathReleased();
-    this->scene()->update();
+    updateAround(sender);
 }
 
 void EditablePath::connectPoints(PathItem *pathItem)
@@ -171,6 +262,52 @@ void EditablePath::connectPoints(PathItem *pathItem)
     }
 }
 
+void EditablePath::updateExtent()
+{
+    for (auto item : _path->pathItems())
+        _itemRects[item.get()] = item->controlPointRect();
+
+    prepareGeometryChange();
+    _boundingRect = _path->controlPointRect();
+    update();
+}
+
+void EditablePath::updateAround(PathPoint *point)
+{
+    // A point moves the items it belongs to, and the control points of their
+    // neighbours when the path is kept continuous
+    QList<std::shared_ptr<PathItem> > items = _path->pathItems();
+    QRectF dirty;
+    for (int i=0; i<items.count(); i++)
+    {
+        PathItem *item = items[i].get();
+        bool moved = item->startPoint().get() == point || item->endPoint().get() == point;
+        for (auto controlPoint : item->controlPoints())
+            moved |= controlPoint.get() == point;
+        if (!moved)
+            continue;
+
+        for (int j=qMax(0, i-1); j<=qMin(items.count()-1, i+1); j++)
+        {
+            const PathItem *affected = items[j].get();
+            QRectF rect = affected->controlPointRect();
+            dirty |= _itemRects.value(affected) | rect;
+            _itemRects[affected] = rect;
+        }
+    }
+
+    QRectF rect = _path->controlPointRect();
+    if (rect != _boundingRect)
+    {
+        prepareGeometryChange();
+        _boundingRect = rect;
+    }
+
+    // Lines are stroked around the extent, handles are centered on the points
+    qreal margin = qMax(_settings->linePen().widthF(), _settings->controlLinePen().widthF()) + _settings->handleSize();
+    update(dirty.adjusted(-margin, -margin, margin, margin));
+}
+
 void EditablePath::emitPathChanged()
 {
     _path->onPathChanged();
@@ -30,14 +30,16 @@
 #include "patheditor/controlpoint.hpp"
 #include "patheditor/curvepoint.hpp"
 #include "patheditor/pathitem.hpp"
+#include "patheditor/pathpoint.hpp"
 #include "patheditor/line.hpp"
 #include "patheditor/cubicbezier.hpp"
 #include "patheditor/pathsettings.hpp"
+#include "patheditor/pathsnapshot.hpp"
 
 using namespace patheditor;
 
 Path::Path(QObject *parent) :
-    QObject(parent)
+    QObject(parent), _snapshotMoves(0), _controlPointRectMoves(0), _controlPointRectValid(false)
 {
 }
 
@@ -56,8 +58,10 @@ void Path::append(std::shared_ptr<PathItem> pathItem)
         pathItem->setStartPoint(_pathItemList.last()->endPoint());
     }
 
-    emit onAppend(pathItem.get());
     _pathItemList.append(pathItem);
+    _controlPointRectValid = false;
+    _snapshot.reset();
+    emit onAppend(pathItem.get());
 }
 
 QList<std::shared_ptr<PathItem> > Path::pathItems()
@@ -72,6 +76,10 @@ QList<const PathItem *> Path::constPathItems() const
 
 QRectF Path::controlPointRect() const
 {
+    // Queried by the scene on every index update, hover and paint
+    if (_controlPointRectValid && _controlPointRectMoves == PathPoint::moveCount())
+        return _controlPointRect;
+
     if (_pathItemList.count() <= 0)
         return QRectF(0,0,0,0);
 
@@ -81,6 +89,9 @@ QRectF Path::controlPointRect() const
         retVal |= item->controlPointRect();
     }
 
+    _controlPointRect = retVal;
+    _controlPointRectMoves = PathPoint::moveCount();
+    _controlPointRectValid = true;
     return retVal;
 }
 
@@ -156,6 +167,21 @@ std::vector<std::vector<QPointF>> Path::bezierItems() const
   return retVal;
 }
 
+std::shared_ptr<const PathSnapshot> Path::snapshot() const
+{
+    // Points are also moved without signals (e.g. restrictors and followers),
+    // compare the geometry rather than relying on pathChanged
+    if (_snapshot && _snapshotMoves == PathPoint::moveCount())
+        return _snapshot;
+    _snapshotMoves = PathPoint::moveCount();
+
+    std::vector<std::vector<QPointF>> items = bezierItems();
+    if (!_snapshot || !_snapshot->sameGeometry(items))
+        _snapshot = std::make_shared<const PathSnapshot>(std::move(items));
+
+    return _snapshot;
+}
+
 void Path::disconnectAll()
 {
   disconnect();
@@ -187,14 +213,29 @@ void Path::paint(QPainter *painter, bool editable, const PathSettings *settings)
 
 Path::~Path() {}
 
+namespace {
+    struct Notification { enum e {
+        Changed = 0x1,
+        Released = 0x2
+    }; };
+}
+
 void Path::onPathChanged()
 {
-    emit pathChanged(this);
+    notify(Notification::Changed);
 }
 
 void Path::onPathReleased()
 {
-    emit pathReleased(this);
+    notify(Notification::Released);
+}
+
+void Path::sendNotifications(unsigned flags)
+{
+    if (flags & Notification::Changed)
+        emit pathChanged(this);
+    if (flags & Notification::Released)
+        emit pathReleased(this);
 }
 
 
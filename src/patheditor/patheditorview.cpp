@@ -23,19 +23,133 @@
 #include "patheditor/patheditorview.hpp"
 
 #include <QDragMoveEvent>
+#include <QFontDatabase>
 #include <QUrl>
 #include <QMimeData>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QTimer>
+#include "hrlib/instrument/instrument.hpp"
+#include "patheditor/pathpoint.hpp"
 #include "patheditor/scalableimage.hpp"
 
 #define MIN_UNIT_SIZE 5
+// Interval of the HUD statistics [ms]
+#define HUD_INTERVAL 500
 
 using namespace patheditor;
+using namespace hrlib::instrument;
+
+namespace {
+    Timer s_paintTimer("PathEditorView::paint");
+    Timer s_gridTimer("PathEditorView::grid");
+    Timer s_latencyTimer("PathEditorView::latency");
+
+    //
+    // Samples all timers once per interval for the HUD of every view
+    //
+    struct Hud
+    {
+        bool visible = false;
+        QList<PathEditorView*> views;
+        QStringList lines;
+        QTimer timer;
+        int64_t lastSample = 0;
+
+        void sample()
+        {
+            int64_t time = now();
+            double seconds = lastSample ? (time - lastSample) / 1e9 : HUD_INTERVAL / 1e3;
+            lastSample = time;
+
+            lines.clear();
+            lines.append(QString("%1 %2 %3 %4").arg("", -32).arg("avg ms", 8).arg("max ms", 8).arg("per s", 7));
+            for (Timer *t : Timer::all())
+            {
+                Timer::Stats stats = t->take();
+                if (stats.count == 0)
+                    continue;
+                lines.append(QString("%1 %2 %3 %4").arg(t->name(), -32)
+                             .arg(stats.total / 1e6 / stats.count, 8, 'f', 2)
+                             .arg(stats.max / 1e6, 8, 'f', 2)
+                             .arg(stats.count / seconds, 7, 'f', 1));
+            }
+
+            for (PathEditorView *view : views)
+                view->viewport()->update();
+        }
+    };
+
+    Hud &hud()
+    {
+        // Created on first use, after the application
+        static Hud *hud = nullptr;
+        if (!hud)
+        {
+            hud = new Hud();
+            QObject::connect(&hud->timer, &QTimer::timeout, [] { ::hud().sample(); });
+        }
+        return *hud;
+    }
+
+    bool isInput(QEvent::Type type)
+    {
+        switch (type) {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseMove:
+        case QEvent::Wheel:
+        case QEvent::KeyPress:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
 
 PathEditorView::PathEditorView(QGraphicsScene *scene, QWidget *parent) :
     QGraphicsView(scene, parent)
 {
     _pxPerUnit = 10;
     _imageItem = 0;
+    _inputTime = 0;
+
+    // The grid is only redrawn on zoom or scale changes, not on every item repaint
+    setCacheMode(QGraphicsView::CacheBackground);
+
+    hud().views.append(this);
+}
+
+PathEditorView::~PathEditorView()
+{
+    hud().views.removeOne(this);
+}
+
+void PathEditorView::setHudVisible(bool visible)
+{
+    Hud &h = hud();
+    h.visible = visible;
+    hrlib::instrument::setEnabled(visible);
+    if (visible)
+    {
+        h.lastSample = now();
+        for (Timer *t : Timer::all())
+            t->take();
+        h.timer.start(HUD_INTERVAL);
+    }
+    else
+    {
+        h.timer.stop();
+        h.lines.clear();
+    }
+
+    for (PathEditorView *view : h.views)
+        view->viewport()->update();
+}
+
+bool PathEditorView::hudVisible()
+{
+    return hud().visible;
 }
 
 void PathEditorView::setPixelsPerUnit(qreal pxPerUnit)
@@ -45,7 +159,18 @@ void PathEditorView::setPixelsPerUnit(qreal pxPerUnit)
     else
         _pxPerUnit = pxPerUnit;
 
-    scene()->update();
+    resetCachedContent();
+    viewport()->update();
+}
+
+QRectF PathEditorView::visibleSceneRect() const
+{
+    return mapToScene(viewport()->rect()).boundingRect();
+}
+
+qreal PathEditorView::sceneScale() const
+{
+    return QStyleOptionGraphicsItem::levelOfDetailFromTransform(transform()) * devicePixelRatioF();
 }
 
 void PathEditorView::setImage(const QUrl &url)
@@ -62,7 +187,8 @@ void PathEditorView::setImage(const QUrl &url)
 
 void PathEditorView::setImage(const QString &path)
 {
-  QPixmap image(path);
+  // Loaded as an image, ScalableImage scales it off the GUI thread
+  QImage image(path);
   if (image.isNull()) image.load(path.right(path.size() - 1));
 
   if (!image.isNull())
@@ -81,6 +207,8 @@ void PathEditorView::setImage(const QString &path)
 
 void PathEditorView::drawBackground(QPainter *painter, const QRectF &rect)
 {
+    Zone zone(s_gridTimer);
+
     // Find a suitable unitSize
     qreal unitSize = _pxPerUnit/100;
     while (unitSize < MIN_UNIT_SIZE)
@@ -93,6 +221,63 @@ void PathEditorView::drawBackground(QPainter *painter, const QRectF &rect)
     drawLinesWithInterval(unitSize*10, painter, rect);
 }
 
+void PathEditorView::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsView::drawForeground(painter, rect);
+
+    const Hud &h = hud();
+    if (!h.visible || h.lines.isEmpty())
+        return;
+
+    painter->save();
+    painter->resetTransform();
+    painter->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    QFontMetrics metrics = painter->fontMetrics();
+    QRect box(0, 0, 0, metrics.lineSpacing() * h.lines.count() + 8);
+    for (const QString &line : h.lines)
+        box.setWidth(qMax(box.width(), metrics.boundingRect(line).width() + 8));
+
+    painter->fillRect(box, QColor(0, 0, 0, 160));
+    painter->setPen(Qt::white);
+    for (int i=0; i<h.lines.count(); i++)
+        painter->drawText(4, 4 + metrics.ascent() + i * metrics.lineSpacing(), h.lines[i]);
+    painter->restore();
+}
+
+bool PathEditorView::viewportEvent(QEvent *event)
+{
+    if (_inputTime != 0 || !hrlib::instrument::enabled() || !isInput(event->type()))
+        return QGraphicsView::viewportEvent(event);
+
+    // Latency is measured from the first input event that moved a point, zoomed or scrolled
+    // to the end of the paint showing it. Input changing nothing, e.g. hovering an empty
+    // area, is not stamped, the next unrelated repaint would count it.
+    int64_t time = now();
+    quint64 moves = PathPoint::moveCount();
+    QTransform transform = viewportTransform();
+
+    bool handled = QGraphicsView::viewportEvent(event);
+
+    if (PathPoint::moveCount() != moves || viewportTransform() != transform)
+        _inputTime = time;
+    return handled;
+}
+
+void PathEditorView::paintEvent(QPaintEvent *event)
+{
+    {
+        Zone zone(s_paintTimer);
+        QGraphicsView::paintEvent(event);
+    }
+
+    if (_inputTime != 0)
+    {
+        if (hrlib::instrument::enabled())
+            s_latencyTimer.record(now() - _inputTime);
+        _inputTime = 0;
+    }
+}
+
 void PathEditorView::dragMoveEvent(QDragMoveEvent *event)
 {
     if (event->mimeData()->hasUrls())
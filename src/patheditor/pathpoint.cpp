@@ -32,6 +32,7 @@
 using namespace patheditor;
 
 static QMap<QGraphicsScene*, PathPoint*> s_prevSelected;
+static quint64 s_moveCount = 0;
 
 PathPoint::PathPoint(qreal xpos, qreal ypos)
     : QPointF(xpos, ypos), _selected(false)
@@ -146,12 +147,23 @@ PointHandle *PathPoint::handle()
     return _pointHandle;
 }
 
+void PathPoint::attachHandle(PointHandle *handle)
+{
+    replaceCurrentPointHandle(handle);
+    _ownsHandle = false;
+}
+
+const QBrush &PathPoint::handleBrush(const PathSettings *settings) const
+{
+    return settings->pointBrush();
+}
+
 void PathPoint::replaceCurrentPointHandle(PointHandle *pointHandle)
 {
     if (_pointHandle == pointHandle)
         return;
 
-    if (_pointHandle)
+    if (_pointHandle && _ownsHandle)
     {
         if (_pointHandle->scene())
             _pointHandle->scene()->removeItem(_pointHandle);
@@ -159,6 +171,7 @@ void PathPoint::replaceCurrentPointHandle(PointHandle *pointHandle)
     }
 
     _pointHandle = pointHandle;
+    _ownsHandle = pointHandle != nullptr;
 }
 
 template<int Precision>
@@ -177,6 +190,7 @@ void PathPoint::setPos(qreal xpos, qreal ypos)
 
     this->setX(xpos);
     this->setY(ypos);
+    s_moveCount++;
 
     if (_pointHandle)
     {
@@ -184,6 +198,11 @@ void PathPoint::setPos(qreal xpos, qreal ypos)
     }
 }
 
+quint64 PathPoint::moveCount()
+{
+    return s_moveCount;
+}
+
 void PathPoint::select(PathPoint *point, QGraphicsScene *scene)
 {
     if (s_prevSelected.contains(scene))
@@ -0,0 +1,128 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "patheditor/pathsnapshot.hpp"
+
+#include <cmath>
+#include "patheditor/pathtemplates.hpp"
+
+using namespace patheditor;
+
+PathSnapshot::PathSnapshot(std::vector<std::vector<QPointF>> bezierItems) :
+    _items(std::move(bezierItems))
+{
+}
+
+std::shared_ptr<const PathSnapshot> PathSnapshot::scaled(qreal sx, qreal sy) const
+{
+    std::vector<std::vector<QPointF>> items(_items);
+    for (auto &item : items)
+        for (QPointF &p : item)
+            p = QPointF(p.x() * sx, p.y() * sy);
+    return std::make_shared<const PathSnapshot>(std::move(items));
+}
+
+bool PathSnapshot::sameGeometry(const std::vector<std::vector<QPointF>> &bezierItems) const
+{
+    // exact comparison, a fuzzy match would hide small edits
+    if (bezierItems.size() != _items.size())
+        return false;
+
+    for (size_t i = 0; i < _items.size(); i++)
+    {
+        if (bezierItems[i].size() != _items[i].size())
+            return false;
+        for (size_t j = 0; j < _items[i].size(); j++)
+            if (bezierItems[i][j].x() != _items[i][j].x() || bezierItems[i][j].y() != _items[i][j].y())
+                return false;
+    }
+    return true;
+}
+
+// Same item selection as Path::pointAtPercent
+const std::vector<QPointF> &PathSnapshot::itemAtPercent(qreal *t) const
+{
+    int pathItemCount = _items.size();
+    qreal itemRange = 1/qreal(pathItemCount);
+
+    int item = 0;
+    while (*t > itemRange && item < pathItemCount-1)
+    {
+        *t -= itemRange;
+        item++;
+    }
+
+    *t = *t/itemRange;
+
+    if (*t<0) *t = 0;
+    if (*t>1) *t = 1;
+
+    return _items[item];
+}
+
+QPointF PathSnapshot::pointAtPercent(qreal t) const
+{
+    const std::vector<QPointF> &p = itemAtPercent(&t);
+
+    if (p.size() == 2)
+        return (p[1] - p[0]) * t + p[0];
+
+    qreal s = 1-t;
+    return s*s*s * p[0] + 3*s*s*t * p[1] + 3*s*t*t * p[2] + t*t*t * p[3];
+}
+
+qreal PathSnapshot::angleAtPercent(qreal t) const
+{
+    const std::vector<QPointF> &p = itemAtPercent(&t);
+
+    if (p.size() == 2)
+        return std::atan2(p[1].y()-p[0].y(), p[1].x()-p[0].x());
+
+    qreal s = 1-t;
+    QPointF d = 3*s*s * (p[1]-p[0]) + 6*s*t * (p[2]-p[1]) + 3*t*t * (p[3]-p[2]);
+    return std::atan2(d.y(), d.x());
+}
+
+qreal PathSnapshot::minX(qreal *t_top) const
+{
+    return extreme<X, Min>(this, t_top);
+}
+
+qreal PathSnapshot::maxX(qreal *t_top) const
+{
+    return extreme<X, Max>(this, t_top);
+}
+
+qreal PathSnapshot::minY(qreal *t_top) const
+{
+    return extreme<Y, Min>(this, t_top);
+}
+
+qreal PathSnapshot::maxY(qreal *t_top) const
+{
+    return extreme<Y, Max>(this, t_top);
+}
+
+std::vector<std::vector<QPointF>> PathSnapshot::bezierItems() const
+{
+    return _items;
+}
@@ -26,11 +26,16 @@
 #include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
 #include <QPainter>
+#include "hrlib/instrument/instrument.hpp"
 #include "patheditor/pathpoint.hpp"
 #include "patheditor/pointcontextmenu.hpp"
 
 using namespace patheditor;
 
+namespace {
+    hrlib::instrument::Timer s_paintTimer("PointHandle::paint");
+}
+
 PointHandle::PointHandle(PathPoint *point, int size, const QBrush &brush, const PathSettings *settings, QGraphicsItem *parent)
   : QGraphicsEllipseItem(0, 0, size, size, parent), _settings(settings)
 {
@@ -44,6 +49,17 @@ PointHandle::PointHandle(PathPoint *point, int size, const QBrush &brush, const
     this->setFlag(QGraphicsItem::ItemIsMovable);
 }
 
+PathPoint *PointHandle::point()
+{
+    return _point;
+}
+
+void PointHandle::setPoint(PathPoint *point)
+{
+    _point = point;
+    setCenter(_point);
+}
+
 void PointHandle::setCenter(QPointF *point)
 {
     this->setPos(*point - _originToCenter);
@@ -56,6 +72,7 @@ void PointHandle::setCenter(qreal &xpos, qreal &ypos)
 
 void PointHandle::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
+    hrlib::instrument::Zone zone(s_paintTimer);
     if (_point->visible())
         QGraphicsEllipseItem::paint(painter, option, widget);
 }
@@ -0,0 +1,74 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "patheditor/pointhandlepool.hpp"
+
+#include "patheditor/pathpoint.hpp"
+#include "patheditor/pathsettings.hpp"
+#include "patheditor/pointhandle.hpp"
+
+using namespace patheditor;
+
+PointHandlePool::PointHandlePool(QGraphicsItem *parent, const PathSettings *settings) :
+    _parent(parent), _settings(settings), _created(0)
+{
+}
+
+PointHandle *PointHandlePool::acquire(PathPoint *point)
+{
+    PointHandle *handle;
+    if (_free.isEmpty())
+    {
+        handle = new PointHandle(point, _settings->handleSize(), point->handleBrush(_settings), _settings, _parent);
+        _created++;
+    }
+    else
+    {
+        handle = _free.takeLast();
+        handle->setPoint(point);
+        handle->setBrush(point->handleBrush(_settings));
+        handle->setVisible(true);
+    }
+
+    handle->setZValue(point->handleZValue());
+    point->attachHandle(handle);
+    return handle;
+}
+
+void PointHandlePool::release(PointHandle *handle, bool detach)
+{
+    if (detach && handle->point()->handle() == handle)
+        handle->point()->attachHandle(nullptr);
+
+    handle->setVisible(false);
+    _free.append(handle);
+}
+
+int PointHandlePool::created() const
+{
+    return _created;
+}
+
+int PointHandlePool::inUse() const
+{
+    return _created - _free.count();
+}
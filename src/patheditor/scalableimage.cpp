@@ -22,22 +22,51 @@
 
 #include "patheditor/scalableimage.hpp"
 #include <QPainter>
+#include <QPaintDevice>
 #include <QGraphicsScene>
+#include <mutex>
 #include "qmath.h"
+#include "hrlib/concurrent/scheduler.hpp"
+#include "hrlib/instrument/instrument.hpp"
 #include "patheditor/pathsettings.hpp"
 #include "patheditor/linerestrictor.hpp"
 #include "patheditor/pointhandle.hpp"
 #include "patheditor/scalepoint.hpp"
 
 using namespace patheditor;
+using namespace hrlib::concurrent;
 
-ScalableImage::ScalableImage(const QPixmap &pixmap, const QRect &initialRect, QGraphicsItem *parent) :
-    QGraphicsObject(parent)
+// Mip levels are halved down to this size
+#define MIN_MIP_SIZE 256
+// Size of the nearest neighbour preview painted until the mip levels are ready
+#define PREVIEW_SIZE 1024
+
+namespace {
+    hrlib::instrument::Timer s_paintTimer("ScalableImage::paint");
+}
+
+struct ScalableImage::Jobs
 {
-    _pixmap = pixmap;
+    std::mutex mutex;
+    // Reset on destruction, the jobs then stop and drop their results
+    ScalableImage *image;
+
+    bool cancelled()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !image;
+    }
+};
+
+ScalableImage::ScalableImage(const QImage &image, const QRect &initialRect, QGraphicsItem *parent) :
+    QGraphicsObject(parent), _dragging(false), _mipsPending(0), _scaling(false), _jobs(std::make_shared<Jobs>())
+{
+    _jobs->image = this;
+
+    _image = image;
     _rect = initialRect;
 
-    qreal imageAR = (qreal)pixmap.height() / (qreal)pixmap.width();
+    qreal imageAR = (qreal)image.height() / (qreal)image.width();
     qreal rectAR = (qreal)_rect.height() / (qreal)_rect.width();
     if (imageAR > rectAR)
         _rect.setWidth(_rect.height() / imageAR);
@@ -52,17 +81,75 @@ ScalableImage::ScalableImage(const QPixmap &pixmap, const QRect &initialRect, QG
     _scalePoint->createPointHandle(this, settings);
 
     connect(_scalePoint.get(), SIGNAL(pointDrag(PathPoint*)), this, SLOT(onScaleMove(PathPoint*)));
-    connect(_scalePoint.get(), SIGNAL(pointRelease(PathPoint*)), this, SLOT(onScaleMove(PathPoint*)));
+    connect(_scalePoint.get(), SIGNAL(pointRelease(PathPoint*)), this, SLOT(onScaleRelease(PathPoint*)));
 
     QPointF botLeft(_rect.bottomLeft());
     QPointF topRight(_rect.topRight());
     std::shared_ptr<LineRestrictor> restrictor(new LineRestrictor(botLeft, topRight));
     _scalePoint->setRestrictor(restrictor);
+
+    connect(this, SIGNAL(mipReady(int,QImage)), this, SLOT(onMipReady(int,QImage)), Qt::QueuedConnection);
+    connect(this, SIGNAL(scaledReady(QImage)), this, SLOT(onScaledReady(QImage)), Qt::QueuedConnection);
+
+    // Photos easily have tens of megapixels, build the mip chain in the background
+    _mips.append(_image);
+    QSize size = _image.size();
+    while (qMax(size.width(), size.height()) > MIN_MIP_SIZE)
+    {
+        size /= 2;
+        _mips.append(QImage());
+    }
+    _mipsPending = _mips.count() - 1;
+
+    if (_mipsPending == 0)
+    {
+        _preview = QPixmap::fromImage(_image);
+    }
+    else
+    {
+        _preview = QPixmap::fromImage(_image.scaled(PREVIEW_SIZE, PREVIEW_SIZE, Qt::KeepAspectRatio, Qt::FastTransformation));
+
+        std::shared_ptr<Jobs> jobs = _jobs;
+        QImage source = _image;
+        int levels = _mips.count();
+        Scheduler::instance().submit([jobs, source, levels]() {
+            QImage level = source;
+            for (int i=1; i<levels && !jobs->cancelled(); i++)
+            {
+                level = level.scaled(level.size() / 2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+                std::lock_guard<std::mutex> lock(jobs->mutex);
+                if (jobs->image)
+                    emit jobs->image->mipReady(i, level);
+            }
+        }, Priority::Background);
+    }
+}
+
+ScalableImage::ScalableImage(const QPixmap &pixmap, const QRect &initialRect, QGraphicsItem *parent) :
+    ScalableImage(pixmap.toImage(), initialRect, parent)
+{
 }
 
 void ScalableImage::paint(QPainter *painter, const QStyleOptionGraphicsItem */*unused*/, QWidget */*unused*/)
 {
-    painter->drawPixmap(_rect, _pixmap);
+    hrlib::instrument::Zone zone(s_paintTimer);
+
+    // Device pixels covered by the image, there is no point in scaling up
+    QRectF device = painter->worldTransform().mapRect(QRectF(_rect));
+    qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1;
+    QSize target = (device.size() * dpr).toSize().boundedTo(_image.size());
+
+    if (!_scaled.isNull() && _scaled.size() == target)
+    {
+        painter->drawPixmap(_rect, _scaled);
+        return;
+    }
+
+    // Rescale once the scale point is released, or after zooming
+    if (!_dragging && !target.isEmpty())
+        requestScaled(target);
+
+    painter->drawPixmap(_rect, mipPixmap(target));
 }
 
 QRectF ScalableImage::boundingRect() const
@@ -70,11 +157,66 @@ QRectF ScalableImage::boundingRect() const
     return QRectF(_rect) | _scalePoint.get()->handle()->boundingRect();
 }
 
-ScalableImage::~ScalableImage() {}
+ScalableImage::~ScalableImage()
+{
+    // Running jobs stop at their next level instead of being waited for
+    std::lock_guard<std::mutex> lock(_jobs->mutex);
+    _jobs->image = nullptr;
+}
+
+const QPixmap &ScalableImage::mipPixmap(const QSize &target)
+{
+    if (_mipsPending > 0 && target.width() <= _preview.width() && target.height() <= _preview.height())
+        return _preview;
+
+    // The smallest ready level covering the target, else the largest ready one scaled up,
+    // converted on first use. The full resolution image is never converted here, the copy
+    // scaled by requestScaled() replaces the scaled up level when it arrives.
+    int level = 0;
+    bool covering = false;
+    for (int i=_mips.count()-1; i>0 && !covering; i--)
+    {
+        if (_mips[i].isNull())
+            continue;
+        level = i;
+        covering = _mips[i].width() >= target.width() && _mips[i].height() >= target.height();
+    }
+
+    if (level == 0 || (!covering && _mips[level].width() < _preview.width()))
+        return _preview;
+
+    auto it = _mipPixmaps.find(level);
+    if (it == _mipPixmaps.end())
+        it = _mipPixmaps.insert(level, QPixmap::fromImage(_mips[level]));
+    return *it;
+}
+
+void ScalableImage::requestScaled(const QSize &size)
+{
+    _wantedSize = size;
+    if (_scaling)
+        return;
+
+    // A single job at a time, the result is checked against the latest wanted size
+    _scaling = true;
+    std::shared_ptr<Jobs> jobs = _jobs;
+    QImage source = _image;
+    Scheduler::instance().submit([jobs, source, size]() {
+        if (jobs->cancelled())
+            return;
+        QImage scaled = source.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        std::lock_guard<std::mutex> lock(jobs->mutex);
+        if (jobs->image)
+            emit jobs->image->scaledReady(scaled);
+    }, Priority::Background);
+}
 
 void ScalableImage::onScaleMove(PathPoint *point)
 {
+    _dragging = true;
+
     QRect oldRect = _rect;
+    prepareGeometryChange();
 
     QPointF relativePnt = *point - _rect.bottomLeft();
 
@@ -83,5 +225,32 @@ void ScalableImage::onScaleMove(PathPoint *point)
 
     _rect.moveBottomLeft(oldRect.bottomLeft());
 
-    this->scene()->update();
+    update();
+}
+
+void ScalableImage::onScaleRelease(PathPoint *point)
+{
+    onScaleMove(point);
+    _dragging = false;
+}
+
+void ScalableImage::onMipReady(int level, QImage image)
+{
+    _mips[level] = image;
+    _mipsPending--;
+    update();
+}
+
+void ScalableImage::onScaledReady(QImage image)
+{
+    _scaling = false;
+    if (image.size() == _wantedSize)
+    {
+        _scaled = QPixmap::fromImage(image);
+        update();
+    }
+    else if (!_dragging && _wantedSize.isValid())
+    {
+        requestScaled(_wantedSize);
+    }
 }
@@ -37,3 +37,8 @@ void ScalePoint::createPointHandleImpl(QGraphicsItem *parent, const PathSettings
     newPointHandle->setZValue(1);
     replaceCurrentPointHandle(newPointHandle);
 }
+
+const QBrush &ScalePoint::handleBrush(const PathSettings *settings) const
+{
+    return settings->scalePointBrush();
+}
@@ -0,0 +1,139 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "foilbenchmarks.hpp"
+
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QtTest>
+#include <functional>
+
+#include "submodules/qtestrunner/qtestrunner.hpp"
+#include "foillogic/contourbands.hpp"
+#include "foillogic/foil.hpp"
+#include "foillogic/foilcalculator.hpp"
+#include "foillogic/outline.hpp"
+#include "patheditor/path.hpp"
+#include "patheditor/pathitem.hpp"
+#include "patheditor/pathpoint.hpp"
+
+using namespace foillogic;
+using namespace patheditor;
+
+void FoilBenchmarks::benchDrag()
+{
+  Foil foil;
+  Path *path = foil.outline()->path();
+  auto point = path->pathItems().first()->endPoint();
+
+  // Move a point on every event at ~500Hz for 400ms
+  auto drag = [&](FoilCalculator &calculator) -> qreal {
+    calculator.wait();
+    int calculations = 0;
+    QMetaObject::Connection connection =
+        QObject::connect(&calculator, &FoilCalculator::foilCalculated, [&calculations]() { calculations++; });
+
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 400)
+      {
+        point->setPos(point->x() + 0.01, point->y());
+        path->onPathChanged();
+        QTest::qWait(2);
+      }
+    qreal calculationsPerSecond = calculations * 1000.0 / timer.elapsed();
+
+    calculator.wait();
+    QObject::disconnect(connection);
+    return calculationsPerSecond;
+  };
+
+  FoilCalculator every(&foil);
+  every.setFrameInterval(0);
+  qreal everyRate = drag(every);
+
+  FoilCalculator coalesced(&foil);
+  coalesced.setFrameInterval(16);
+  qreal coalescedRate = drag(coalesced);
+
+  qInfo("drag calculations per second: every event %.1f, coalesced %.1f", everyRate, coalescedRate);
+}
+
+void FoilBenchmarks::benchBands()
+{
+  Foil foil;
+  FoilCalculator calculator(&foil);
+  QRectF rect = foil.outline()->path()->controlPointRect();
+
+  for (int layers : { 12, 40, 100 })
+  {
+    calculator.setEquidistantContours(layers);
+    calculator.wait();
+    QList<std::shared_ptr<QPainterPath>> contours = calculator.topContours();
+    QList<QColor> colors;
+    for (int i=0; i<contours.count(); i++)
+      colors.append(QColor::fromHsv(i * 359 / contours.count(), 200, 200, 100));
+
+    auto paint = [&rect](const std::function<void(QPainter&)> &draw) {
+      QImage image(rect.size().toSize() + QSize(2, 2), QImage::Format_ARGB32_Premultiplied);
+      image.fill(Qt::white);
+      QPainter painter(&image);
+      painter.translate(-rect.topLeft() + QPointF(1, 1));
+      painter.setPen(Qt::NoPen);
+      draw(painter);
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    paint([&](QPainter &painter) {
+      for (int i=0; i<contours.count(); i++)
+      {
+        painter.setBrush(colors[i]);
+        painter.drawPath(*contours[i]);
+      }
+    });
+    qint64 stackedNs = timer.nsecsElapsed();
+
+    // Built by the calculator in the background, timed separately from painting them
+    timer.restart();
+    ContourBands bands(contours);
+    qint64 constructionNs = timer.nsecsElapsed();
+
+    timer.restart();
+    paint([&](QPainter &painter) {
+      for (int i=0; i<bands.count(); i++)
+      {
+        QList<QColor> covering;
+        for (int c : bands.covering(i))
+          covering.append(colors[c]);
+        painter.setBrush(ContourBands::composite(covering));
+        painter.drawPath(bands.band(i));
+      }
+    });
+    qint64 bandedNs = timer.nsecsElapsed();
+
+    qInfo("%d layers: stacked %.2f ms, bands built %.2f ms and painted %.2f ms",
+          layers, stackedNs / 1e6, constructionNs / 1e6, bandedNs / 1e6);
+  }
+}
+
+QTR_ADD_TEST(FoilBenchmarks)
@@ -0,0 +1,125 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+
+#include "pathbenchmarks.hpp"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <QElapsedTimer>
+#include <QGraphicsItem>
+
+#include "submodules/qtestrunner/qtestrunner.hpp"
+#include "foillogic/foilio.hpp"
+#include "foillogic/outline.hpp"
+#include "foillogic/profile.hpp"
+#include "patheditor/curvepoint.hpp"
+#include "patheditor/editablepath.hpp"
+#include "patheditor/line.hpp"
+#include "patheditor/path.hpp"
+#include "patheditor/pointhandlepool.hpp"
+
+using namespace patheditor;
+
+namespace
+{
+  // Reports handle creation and a hover hit-test proxy, for all handles versus a culled viewport
+  void benchPath(const std::string &name, Path *path)
+  {
+    QRectF rect = path->controlPointRect();
+    QRectF viewport(rect.center(), rect.size() / 10);
+    viewport.translate(-viewport.width() / 2, -viewport.height() / 2);
+
+    // Hover hit-testing visits every handle item
+    auto hover = [&rect](const EditablePath &editable) {
+      int hits = 0;
+      for (int i=0; i<=20; i++)
+        for (int j=0; j<=20; j++)
+        {
+          QPointF pos(rect.left() + rect.width() * i / 20, rect.top() + rect.height() * j / 20);
+          for (QGraphicsItem *item : editable.childItems())
+            hits += item->isVisible() && item->mapRectToParent(item->boundingRect()).contains(pos);
+        }
+      return hits;
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    EditablePath all(path);
+    all.syncHandles();
+    qint64 allLoadNs = timer.nsecsElapsed();
+    timer.restart();
+    hover(all);
+    qint64 allHoverNs = timer.nsecsElapsed();
+
+    timer.restart();
+    EditablePath culled(path);
+    culled.syncHandles(viewport);
+    qint64 culledLoadNs = timer.nsecsElapsed();
+    timer.restart();
+    hover(culled);
+    qint64 culledHoverNs = timer.nsecsElapsed();
+
+    qInfo("%s, %d points: all %d handles, load %.2f ms, hover %.2f ms; culled %d handles, load %.2f ms, hover %.2f ms",
+          name.c_str(), path->pathItems().count() + 1, all.handlePool()->inUse(), allLoadNs / 1e6, allHoverNs / 1e6,
+          culled.handlePool()->inUse(), culledLoadNs / 1e6, culledHoverNs / 1e6);
+  }
+}
+
+void PathBenchmarks::benchHandles()
+{
+  for (const std::filesystem::directory_entry &p : std::filesystem::directory_iterator("testdata/profiles/"))
+  {
+    if (p.path().extension().string()!=".dat")
+      continue;
+
+    std::ifstream ifs(p.path().string());
+    std::unique_ptr<foillogic::Profile> profile(foillogic::loadProfileDatStream(ifs));
+    QVERIFY(profile);
+    benchPath(p.path().filename().string(), profile->topProfile());
+  }
+
+  for (const std::filesystem::directory_entry &p : std::filesystem::directory_iterator("testdata/outlines/"))
+  {
+    if (p.path().extension().string()!=".pdf")
+      continue;
+
+    std::ifstream ifs(p.path().string());
+    std::unique_ptr<foillogic::Outline> outline(foillogic::loadOutlinePdfStream(ifs));
+    QVERIFY(outline);
+    benchPath(p.path().filename().string(), outline->path());
+  }
+
+  // A large path, as traced from an image
+  Path path;
+  std::shared_ptr<PathPoint> point = std::make_shared<CurvePoint>(0, 0);
+  for (int i=1; i<=5000; i++)
+  {
+    auto next = std::make_shared<CurvePoint>(i, 50 * std::sin(i / 100.0));
+    path.append(std::make_shared<Line>(point, next));
+    point = next;
+  }
+  benchPath("traced", &path);
+}
+
+QTR_ADD_TEST(PathBenchmarks)
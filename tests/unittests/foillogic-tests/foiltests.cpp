@@ -22,6 +22,7 @@
 
 #include "foiltests.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
 
@@ -171,4 +172,824 @@ void FoilTests::testAreaSweepCalc()
   QVERIFY(std::abs(foil.outline()->sweep().value() - M_PI/4) < 1e-3);
 }
 
+#include <cmath>
+#include <limits>
+#include "foillogic/contourcalculator.hpp"
+#include "foillogic/profile.hpp"
+#include "foillogic/thicknessprofile.hpp"
+#include "hrlib/patterns/decorator.hpp"
+#include "patheditor/pathdecorators.hpp"
+void FoilTests::testAdaptiveSections()
+{
+  Foil foil;
+  auto outline = hrlib::patterns::decorate<PathScaleDecorator>(foil.outline()->path(), 1, -1);
+  auto thickness = hrlib::patterns::decorate<PathScaleDecorator>(foil.thicknessProfile()->topProfile(), 1, -1);
+  auto profile = hrlib::patterns::decorate<PathScaleDecorator>(foil.profile()->topProfile(), 1, -1);
+
+  size_t previousCount = 0;
+  for (qreal tolerance : {0.01, 0.001, 0.0001})
+    {
+      QPainterPath contour;
+      ContourCalculator<QPainterPath> calc(&contour, 0.5, outline.get(), thickness.get(), profile.get(),
+                                           false, tolerance, 100);
+      calc.run();
+      QVERIFY(!contour.isEmpty());
+
+      // A tighter tolerance only adds sections
+      QVERIFY(calc.sectionCount() >= previousCount);
+      previousCount = calc.sectionCount();
+    }
+}
+
+namespace {
+  qreal segmentDistance(const QPointF &p, const QPointF &a, const QPointF &b)
+  {
+    QPointF ab = b - a;
+    qreal length = QPointF::dotProduct(ab, ab);
+    qreal t = length > 0 ? qBound(qreal(0), QPointF::dotProduct(p - a, ab) / length, qreal(1)) : 0;
+    QPointF diff = p - (a + ab*t);
+    return std::sqrt(QPointF::dotProduct(diff, diff));
+  }
+
+  // Largest distance of a point of polyline a to polyline b
+  qreal polylineDistance(const QPainterPath &a, const QPainterPath &b)
+  {
+    qreal max = 0;
+    for (int i=0; i<a.elementCount(); i++)
+      {
+        QPointF p = a.elementAt(i);
+        qreal min = std::numeric_limits<qreal>::max();
+        for (int j=1; j<b.elementCount(); j++)
+          if (!b.elementAt(j).isMoveTo())
+            min = qMin(min, segmentDistance(p, b.elementAt(j-1), b.elementAt(j)));
+        max = qMax(max, min);
+      }
+    return max;
+  }
+}
+
+void FoilTests::testContourError()
+{
+  Foil foil;
+  auto outline = hrlib::patterns::decorate<PathScaleDecorator>(foil.outline()->path(), 1, -1);
+  auto thickness = hrlib::patterns::decorate<PathScaleDecorator>(foil.thicknessProfile()->topProfile(), 1, -1);
+  auto profile = hrlib::patterns::decorate<PathScaleDecorator>(foil.profile()->topProfile(), 1, -1);
+  qreal height = outline->maxY();
+
+  for (qreal level : {0.1, 0.5, 0.9})
+    {
+      QPainterPath reference;
+      ContourCalculator<QPainterPath> dense(&reference, level, outline.get(), thickness.get(), profile.get(),
+                                            false, 0.00002, 4000);
+      dense.run();
+
+      // The sections are within the tolerance of the contour and so is the spline
+      // through them, including corners of the outline between the sections
+      for (qreal tolerance : {0.004, 0.001})
+        {
+          QPainterPath contour;
+          ContourCalculator<QPainterPath> calc(&contour, level, outline.get(), thickness.get(), profile.get(),
+                                               false, tolerance, 500);
+          calc.run();
+          qreal error = qMax(polylineDistance(contour, reference), polylineDistance(reference, contour));
+          QVERIFY(error <= 2 * tolerance * height);
+        }
+    }
+}
+
+void FoilTests::testParallelSections()
+{
+  Foil foil;
+  auto outline = hrlib::patterns::decorate<PathScaleDecorator>(foil.outline()->path(), 1, -1);
+  auto thickness = hrlib::patterns::decorate<PathScaleDecorator>(foil.thicknessProfile()->topProfile(), 1, -1);
+  auto profile = hrlib::patterns::decorate<PathScaleDecorator>(foil.profile()->topProfile(), 1, -1);
+
+  QPainterPath serial;
+  ContourCalculator<QPainterPath> serialCalc(&serial, 0.5, outline.get(), thickness.get(), profile.get(),
+                                             false, 0.0001, 100);
+  serialCalc.run();
+
+  // Chunking only changes where the sections are evaluated, not the contour
+  for (size_t chunks : {2, 7, 64})
+    {
+      QPainterPath chunked;
+      ContourCalculator<QPainterPath> calc(&chunked, 0.5, outline.get(), thickness.get(), profile.get(),
+                                           false, 0.0001, 100);
+      calc.setSectionChunks(chunks);
+      calc.run();
+
+      QCOMPARE(calc.sectionCount(), serialCalc.sectionCount());
+      QCOMPARE(chunked.elementCount(), serial.elementCount());
+      for (int i=0; i<serial.elementCount(); i++)
+        QCOMPARE(QPointF(chunked.elementAt(i)), QPointF(serial.elementAt(i)));
+    }
+}
+
+#include "foillogic/samplers.hpp"
+void FoilTests::testFeatureSampler()
+{
+  FeatureSampler sampler;
+  sampler.addUniformSamples(0, 1, 10);
+  sampler.addUniformSamples(0.05, 1.05, 10);
+  // duplicates of the first stream and of the initial 0 sample
+  sampler.addUniformSamples(0, 1, 5);
+
+  const std::vector<qreal> &samples = sampler.samples();
+  QCOMPARE(samples.size(), size_t(20));
+  QVERIFY(std::is_sorted(samples.begin(), samples.end()));
+  QCOMPARE(samples.front(), 0.0);
+  QCOMPARE(samples.back(), 0.95);
+
+  std::vector<qreal> sampled = sampler.sampleAt(4);
+  QCOMPARE(sampled.size(), size_t(4));
+  QCOMPARE(sampled[1], samples[5]);
+}
+
+void FoilTests::testThicknessLookup()
+{
+  Foil foil;
+  auto thickness = hrlib::patterns::decorate<PathScaleDecorator>(foil.thicknessProfile()->topProfile(), 1, -1);
+  ThicknessLookup lookup(thickness.get());
+
+  std::vector<qreal> heights, expected;
+  for (qreal perc=0; perc<=1; perc+=0.01)
+    {
+      QPointF p = thickness->pointAtPercent(perc);
+      heights.push_back(p.x());
+      expected.push_back(p.y());
+    }
+
+  std::vector<qreal> sampled = lookup.sample(heights);
+  for (size_t i=0; i<heights.size(); i++)
+    {
+      QVERIFY(std::abs(sampled[i] - expected[i]) < 1e-6);
+      QVERIFY(std::abs(lookup.thicknessAt(heights[i]) - expected[i]) < 1e-6);
+    }
+}
+
+void FoilTests::testSymmetricContours()
+{
+  Foil foil;
+  QCOMPARE(foil.profile()->symmetry(), Profile::Symmetric);
+
+  FoilCalculator calculator(&foil);
+  calculator.setEquidistantContours(4);
+  calculator.wait();
+
+  // The bottom contour at t is the top contour at 1-t, calculated only once
+  auto topContours = calculator.topContours();
+  auto botContours = calculator.bottomContours();
+  QVERIFY(!botContours.isEmpty());
+  for (const auto &contour : botContours)
+    QVERIFY(topContours.contains(contour));
+}
+
+#include "foillogic/foilgeometry.hpp"
+#include "patheditor/pathsnapshot.hpp"
+#include "patheditor/pathitem.hpp"
+#include "patheditor/pathpoint.hpp"
+void FoilTests::testGeometrySnapshot()
+{
+  Foil foil;
+  Path *outline = foil.outline()->path();
+  auto snapshot = foil.snapshot();
+
+  // The snapshot evaluates like the live path
+  std::vector<QPointF> sampled;
+  for (qreal t=0; t<=1; t+=0.05)
+    {
+      sampled.push_back(snapshot->outline->pointAtPercent(t));
+      QCOMPARE(sampled.back(), outline->pointAtPercent(t));
+    }
+
+  // Unchanged paths are shared between snapshots
+  auto unchanged = foil.snapshot();
+  QVERIFY(unchanged->outline == snapshot->outline);
+  QVERIFY(unchanged->topProfile == snapshot->topProfile);
+
+  // Edits create a new outline snapshot and leave the earlier one untouched
+  auto point = outline->pathItems().first()->endPoint();
+  point->setPos(point->x() + 10, point->y() + 10);
+  auto edited = foil.snapshot();
+  QVERIFY(edited->outline != snapshot->outline);
+  QVERIFY(edited->topProfile == snapshot->topProfile);
+  for (size_t i=0; i<sampled.size(); i++)
+    QCOMPARE(snapshot->outline->pointAtPercent(i*0.05), sampled[i]);
+}
+
+#include "foillogic/derived.hpp"
+void FoilTests::testDerivedQuantities()
+{
+  auto counter = [](const char *name) -> DerivedCounter* {
+    for (DerivedCounter *c : DerivedCounter::all())
+      if (QString(c->name()) == name)
+        return c;
+    return nullptr;
+  };
+  DerivedCounter *profileTop = counter("Profile::profileTop");
+  DerivedCounter *areaSweep = counter("FoilCalculator::areaSweep");
+  QVERIFY(profileTop && areaSweep);
+
+  Foil foil;
+  QPointF top = foil.profile()->topProfileTop();
+  foil.profile()->bottomProfileTop();
+
+  // Repeated queries are served from the cache
+  profileTop->reset();
+  QCOMPARE(foil.profile()->topProfileTop(), top);
+  foil.profile()->pxThickness();
+  QCOMPARE(profileTop->hits(), 3ull);
+  QCOMPARE(profileTop->misses(), 0ull);
+
+  // Moving a point of the top profile only invalidates its top
+  auto point = foil.profile()->topProfile()->pathItems().first()->endPoint();
+  point->setPos(point->x(), point->y() - 5);
+  QVERIFY(foil.profile()->topProfileTop() != top);
+  foil.profile()->bottomProfileTop();
+  QCOMPARE(profileTop->misses(), 1ull);
+
+  // Recalculating an unchanged foil reuses the area and sweep
+  FoilCalculator calculator(&foil);
+  calculator.wait();
+  areaSweep->reset();
+  calculator.calculate(true);
+  QCOMPARE(areaSweep->hits(), 1ull);
+  QCOMPARE(areaSweep->misses(), 0ull);
+  QVERIFY(areaSweep->hitRate() == 1);
+}
+
+#include <QtTest>
+#include "patheditor/curvepoint.hpp"
+void FoilTests::testAsyncResults()
+{
+  Foil foil;
+  FoilCalculator calculator(&foil);
+  calculator.setFrameInterval(0);
+  calculator.wait();
+  int calculations = 0;
+  QObject::connect(&calculator, &FoilCalculator::foilCalculated, [&calculations]() { calculations++; });
+
+  // The results are delivered by the event loop, not by calculate()
+  auto shown = calculator.topPolylines();
+  calculator.calculate(false);
+  QCOMPARE(calculations, 0);
+  QCOMPARE(calculator.topPolylines(), shown);
+  QTRY_COMPARE(calculations, 1);
+
+  // Drag previews during a running preview only calculate the latest geometry once it is done
+  calculations = 0;
+  Path *path = foil.outline()->path();
+  auto point = path->pathItems().first()->endPoint();
+  for (int i=0; i<10; i++)
+  {
+    point->setPos(point->x() + 1, point->y());
+    calculator.calculate(true);
+  }
+  calculator.wait();
+  QCOMPARE(calculations, 2);
+  FoilCalculator reference(&foil);
+  reference.calculate(true);
+  reference.wait();
+  QCOMPARE(calculator.topPolylines().first()->pointCount(), reference.topPolylines().first()->pointCount());
+  QCOMPARE(calculator.topPolylines().first()->point(0), reference.topPolylines().first()->point(0));
+
+  // Results of a replaced foil are stale
+  calculations = 0;
+  calculator.calculate(false);
+  Foil other;
+  calculator.setFoil(&other);
+  calculator.wait();
+  QCOMPARE(calculations, 1);
+}
+
+void FoilTests::testChangeTransaction()
+{
+  Foil foil;
+  FoilCalculator calculator(&foil);
+  calculator.setFrameInterval(0);
+  calculator.wait();
+  int calculations = 0;
+  QObject::connect(&calculator, &FoilCalculator::foilCalculated, [&calculations]() { calculations++; });
+
+  // A symmetry change moves all bottom points, it recalculates once without a foil transaction
+  foil.profile()->setSymmetry(Profile::Asymmetric);
+  QTest::qWait(20);
+  calculator.wait();
+  QCOMPARE(calculations, 1);
+
+  // A bulk edit recalculates once, when the outermost transaction ends
+  calculations = 0;
+  {
+    Foil::ChangeTransaction transaction(&foil);
+    foil.profile()->setSymmetry(Profile::Symmetric);
+    {
+      Foil::ChangeTransaction nested(&foil);
+      foil.outline()->path()->onPathChanged();
+      foil.outline()->path()->onPathReleased();
+      calculator.setEquidistantContours(6);
+    }
+    QCOMPARE(calculations, 0);
+  }
+  calculator.wait();
+  QCOMPARE(calculations, 1);
+
+  // Splitting a point in the thickness editor rebuilds the thickness profile, as ThicknessEditor::onPathChange
+  calculations = 0;
+  int mirrored = 0;
+  QObject::connect(foil.thicknessProfile(), &ThicknessProfile::mirrored, [&mirrored]() { mirrored++; });
+  {
+    Foil::ChangeTransaction transaction(&foil);
+    Path *split = new Path();
+    for (auto item : foil.thicknessProfile()->topProfile()->pathItems())
+      split->append(item->clone());
+    auto last = split->pathItems().last();
+    auto end = last->endPoint();
+    auto middle = std::make_shared<CurvePoint>((last->startPoint()->x() + end->x())/2,
+                                               (last->startPoint()->y() + end->y())/2);
+    last->setEndPoint(middle);
+    split->append(std::make_shared<Line>(middle, end));
+    foil.thicknessProfile()->pSetTopProfile(split);
+    foil.notifyReleased();
+  }
+  QTest::qWait(20);
+  calculator.wait();
+  QCOMPARE(calculations, 1);
+  QCOMPARE(mirrored, 1);
+  QCOMPARE(foil.thicknessProfile()->botProfile()->pathItems().count(), 3);
+
+  // Path transactions send each notification once
+  int pathChanges = 0;
+  Path *path = foil.outline()->path();
+  QObject::connect(path, &Path::pathChanged, [&pathChanges]() { pathChanges++; });
+  {
+    Path::ChangeTransaction transaction(path);
+    path->onPathChanged();
+    path->onPathChanged();
+  }
+  QCOMPARE(pathChanges, 1);
+}
+
+void FoilTests::testDragCoalescing()
+{
+  Foil foil;
+  Path *path = foil.outline()->path();
+  auto point = path->pathItems().first()->endPoint();
+  FoilCalculator calculator(&foil);
+  calculator.setFrameInterval(16);
+  calculator.wait();
+  int calculations = 0;
+  QObject::connect(&calculator, &FoilCalculator::foilCalculated, [&calculations]() { calculations++; });
+
+  // The drag events of a frame are calculated once, when the frame timer fires
+  for (int frame=1; frame<=3; frame++)
+    {
+      for (int i=0; i<10; i++)
+        {
+          point->setPos(point->x() + 0.1, point->y());
+          path->onPathChanged();
+        }
+      QCOMPARE(calculations, frame - 1);
+      QTRY_COMPARE(calculations, frame);
+    }
+  QTest::qWait(3*calculator.frameInterval());
+  QCOMPARE(calculations, 3);
+
+  // On the geometry at the end of the frame
+  FoilCalculator reference(&foil);
+  reference.calculate(true);
+  reference.wait();
+  QList<std::shared_ptr<QPainterPath>> contours = calculator.topContours();
+  QCOMPARE(contours.count(), reference.topContours().count());
+  for (int i=0; i<contours.count(); i++)
+    QCOMPARE(contours[i]->elementCount(), reference.topContours()[i]->elementCount());
+  QCOMPARE(contours.first()->elementAt(0).x, reference.topContours().first()->elementAt(0).x);
+}
+
+#include <QTemporaryDir>
+#include "foillogic/contourcache.hpp"
+namespace {
+  DerivedCounter *contourCacheCounter()
+  {
+    for (DerivedCounter *c : DerivedCounter::all())
+      if (QString(c->name()) == "ContourCache")
+        return c;
+    return nullptr;
+  }
+}
+
+void FoilTests::testContourCacheRoundTrip()
+{
+  DerivedCounter *counter = contourCacheCounter();
+  QVERIFY(counter);
+
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  auto cache = std::make_shared<ContourCache>(dir.path());
+
+  // The first calculation misses and stores its results
+  Foil foil;
+  counter->reset();
+  FoilCalculator first(&foil, cache);
+  first.wait();
+  QCOMPARE(counter->hits(), 0ull);
+  QCOMPARE(counter->misses(), 1ull);
+  QCOMPARE(QDir(dir.path()).entryList(QDir::Files).count(), 1);
+  qreal area = foil.outline()->area().value();
+  qreal sweep = foil.outline()->sweep().value();
+
+  // Reopening the unchanged design restores the results
+  Foil reopened;
+  FoilCalculator second(&reopened, cache);
+  second.wait();
+  QCOMPARE(counter->hits(), 1ull);
+  QCOMPARE(second.topContours().count(), first.topContours().count());
+  QCOMPARE(second.bottomContours().count(), first.bottomContours().count());
+  for (int i=0; i<first.topContours().count(); i++)
+  {
+    const QPainterPath &expected = *first.topContours()[i];
+    const QPainterPath &restored = *second.topContours()[i];
+    QCOMPARE(restored.elementCount(), expected.elementCount());
+    for (int j=0; j<expected.elementCount(); j++)
+    {
+      QCOMPARE(restored.elementAt(j).type, expected.elementAt(j).type);
+      QVERIFY(qAbs(restored.elementAt(j).x - expected.elementAt(j).x) < 1e-3);
+      QVERIFY(qAbs(restored.elementAt(j).y - expected.elementAt(j).y) < 1e-3);
+    }
+  }
+  // Contours shared by both sides of the symmetric foil are restored shared
+  QVERIFY(!second.bottomPolylines().isEmpty());
+  for (const auto &contour : second.bottomPolylines())
+    QVERIFY(second.topPolylines().contains(contour));
+  QCOMPARE(reopened.outline()->area().value(), area);
+  QCOMPARE(reopened.outline()->sweep().value(), sweep);
+}
+
+void FoilTests::testContourCacheMisses()
+{
+  DerivedCounter *counter = contourCacheCounter();
+  QVERIFY(counter);
+
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  auto cache = std::make_shared<ContourCache>(dir.path());
+  Foil foil;
+  FoilCalculator calculator(&foil, cache);
+  calculator.wait();
+
+  // Other geometry or parameters miss
+  counter->reset();
+  calculator.setContourTolerance(calculator.contourTolerance() / 2);
+  auto point = foil.profile()->topProfile()->pathItems().first()->endPoint();
+  point->setPos(point->x(), point->y() - 5);
+  foil.profile()->topProfile()->onPathReleased();
+  calculator.wait();
+  QCOMPARE(counter->hits(), 0ull);
+  QCOMPARE(counter->misses(), 2ull);
+
+  // Corrupt files are misses
+  for (const QString &name : QDir(dir.path()).entryList(QDir::Files))
+  {
+    QFile file(dir.filePath(name));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    file.resize(file.size() / 2);
+  }
+  counter->reset();
+  calculator.calculate(false);
+  calculator.wait();
+  QCOMPARE(counter->hits(), 0ull);
+  QCOMPARE(counter->misses(), 1ull);
+}
+
+void FoilTests::testContourCacheViewFill()
+{
+  DerivedCounter *counter = contourCacheCounter();
+  QVERIFY(counter);
+
+  // With a view the full fidelity results are stored in the background,
+  // reopening after an edit restores them into the view
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  auto cache = std::make_shared<ContourCache>(dir.path());
+  Foil edited;
+  FoilCalculator viewed(&edited, cache);
+  viewed.wait();
+  QRectF outline = edited.outline()->path()->controlPointRect();
+  viewed.setView(Side::Top, outline, 0.05);
+  viewed.setView(Side::Bottom, outline, 0.05);
+  auto moved = edited.outline()->path()->pathItems().first()->endPoint();
+  QPointF editedPos(moved->x() + 5, moved->y());
+  moved->setPos(editedPos.x(), editedPos.y());
+  edited.outline()->path()->onPathReleased();
+  viewed.wait();
+  QCOMPARE(QDir(dir.path()).entryList(QDir::Files).count(), 2);
+
+  Foil reopenedEdited;
+  auto reopenedPoint = reopenedEdited.outline()->path()->pathItems().first()->endPoint();
+  reopenedPoint->setPos(editedPos.x(), editedPos.y());
+  counter->reset();
+  viewed.setFoil(&reopenedEdited);
+  viewed.wait();
+  QCOMPARE(counter->hits(), 1ull);
+  viewed.setFoil(&edited);
+  viewed.wait();
+}
+
+void FoilTests::testContourCacheLru()
+{
+  Foil foil;
+  FoilCalculator calculator(&foil);
+  calculator.wait();
+
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  ContourCache cache(dir.path());
+  auto path = [&dir](const QByteArray &key) {
+    return QDir(dir.path()).filePath(QString::fromLatin1(key.toHex()) + ".ffc");
+  };
+  // Explicit times, independent of the file system's time resolution
+  auto setTime = [&path](const QByteArray &key, const QDateTime &time) {
+    QFile file(path(key));
+    return file.open(QIODevice::Append) && file.setFileTime(time, QFileDevice::FileModificationTime);
+  };
+
+  ContourCache::Entry entry = { calculator.topPolylines(), calculator.bottomPolylines(), 1, 2, 3 };
+  QVERIFY(cache.store("a", entry));
+  qint64 size = QFileInfo(path("a")).size();
+  QVERIFY(cache.store("b", entry));
+  QDateTime now = QDateTime::currentDateTime();
+  QVERIFY(setTime("a", now.addSecs(-200)));
+  QVERIFY(setTime("b", now.addSecs(-100)));
+
+  // Loads refresh the time
+  ContourCache::Entry loaded;
+  QVERIFY(cache.load("a", &loaded));
+  QVERIFY(QFileInfo(path("a")).lastModified() > now.addSecs(-100));
+
+  // Beyond the maximum size the least recently used files are removed, down to 3/4 of it
+  cache.setMaxSize(3 * size - 1);
+  QVERIFY(cache.store("c", entry));
+  QCOMPARE(QDir(dir.path()).entryList(QDir::Files).count(), 2);
+  QVERIFY(cache.load("a", &loaded));
+  QVERIFY(!cache.load("b", &loaded));
+  QVERIFY(cache.load("c", &loaded));
+}
+
+void FoilTests::testLevelMemoization()
+{
+  DerivedCounter *levels = nullptr;
+  for (DerivedCounter *c : DerivedCounter::all())
+    if (QString(c->name()) == "FoilCalculator::levels")
+      levels = c;
+  QVERIFY(levels);
+
+  Foil foil;
+  foil.profile()->setSymmetry(Profile::Asymmetric);
+  FoilCalculator calculator(&foil);
+  calculator.setContourThicknesses(QList<qreal>() << 0.2 << 0.5);
+  calculator.wait();
+  auto top = calculator.topContours();
+  auto bot = calculator.bottomContours();
+
+  // Adding a level only calculates the new one
+  levels->reset();
+  calculator.setContourThicknesses(QList<qreal>() << 0.2 << 0.5 << 0.8);
+  QCOMPARE(levels->hits(), static_cast<unsigned long long>(top.count() + bot.count()));
+  QVERIFY(levels->misses() > 0);
+  calculator.wait();
+  QVERIFY(calculator.topContours().contains(top.first()));
+
+  // Toggling back calculates nothing
+  levels->reset();
+  calculator.setContourThicknesses(QList<qreal>() << 0.2 << 0.5);
+  QCOMPARE(levels->misses(), 0ull);
+  calculator.wait();
+  QCOMPARE(calculator.topContours(), top);
+  QCOMPARE(calculator.bottomContours(), bot);
+
+  // Overlapping release calculations may both miss a new level and both store it,
+  // it remains cached once
+  calculator.setContourThicknesses(QList<qreal>() << 0.2 << 0.5 << 0.6);
+  calculator.calculate(false);
+  calculator.wait();
+  levels->reset();
+  calculator.calculate(false);
+  QCOMPARE(levels->misses(), 0ull);
+  calculator.wait();
+
+  // Storing a cached level replaces it instead of adding a duplicate
+  static DerivedCounter counter("FoilTests::levels");
+  DerivedCache<int, int> cache(counter, 2);
+  cache.store(1, 1);
+  cache.store(2, 2);
+  cache.store(3, 1);
+  QCOMPARE(cache.size(), size_t(2));
+  QVERIFY(cache.find(2));
+  QCOMPARE(*cache.find(1), 3);
+
+  // Changed geometry invalidates all levels
+  levels->reset();
+  auto point = foil.outline()->path()->pathItems().first()->endPoint();
+  point->setPos(point->x() + 5, point->y());
+  foil.outline()->path()->onPathReleased();
+  QCOMPARE(levels->hits(), 0ull);
+  QCOMPARE(levels->misses(), static_cast<unsigned long long>(top.count() + bot.count()));
+}
+
+void FoilTests::testViewDetail()
+{
+  Foil foil;
+  FoilCalculator calculator(&foil);
+  auto elements = [](const QList<std::shared_ptr<QPainterPath>> &contours) {
+    int count = 0;
+    for (const auto &contour : contours)
+      count += contour->elementCount();
+    return count;
+  };
+  calculator.calculateFull();
+  calculator.wait();
+  int full = elements(calculator.topContours());
+  int levels = calculator.topContours().count();
+
+  // Zoomed out, the contours collapse to a few pixels and need less detail
+  QRectF outline = foil.outline()->path()->controlPointRect();
+  calculator.setView(Side::Top, outline, 0.05);
+  calculator.setView(Side::Bottom, outline, 0.05);
+  calculator.calculate(false);
+  calculator.wait();
+  QCOMPARE(calculator.topContours().count(), levels);
+  QVERIFY(elements(calculator.topContours()) < full);
+
+  // Zooming in on the tip recalculates once the view settles
+  int calculations = 0;
+  QObject::connect(&calculator, &FoilCalculator::foilCalculated, [&calculations]() { calculations++; });
+  QRectF tip(outline.left(), outline.top(), outline.width(), outline.height() / 10);
+  calculator.setView(Side::Top, tip, 50);
+  calculator.setView(Side::Bottom, tip, 50);
+  QTRY_COMPARE(calculations, 1);
+
+  // Scrolling within the refined margin does not
+  calculator.setView(Side::Top, tip.translated(0, tip.height() / 4), 50);
+  QTest::qWait(200);
+  QCOMPARE(calculations, 1);
+
+  // Full fidelity regardless of the view
+  calculator.calculateFull();
+  calculator.wait();
+  QCOMPARE(elements(calculator.topContours()), full);
+}
+
+#include <functional>
+#include "foillogic/contourbands.hpp"
+void FoilTests::testBandPainting()
+{
+  Foil foil;
+  FoilCalculator calculator(&foil);
+  QRectF rect = foil.outline()->path()->controlPointRect();
+
+  for (int layers : { 12, 40 })
+  {
+    calculator.setEquidistantContours(layers);
+    calculator.wait();
+    QList<std::shared_ptr<QPainterPath>> contours = calculator.topContours();
+    QList<QColor> colors;
+    for (int i=0; i<contours.count(); i++)
+      colors.append(QColor::fromHsv(i * 359 / contours.count(), 200, 200, 100));
+
+    // Release results come with their bands, one per contour
+    std::shared_ptr<const ContourBands> bands = calculator.topBands();
+    QVERIFY(bands);
+    QCOMPARE(bands->count(), contours.count());
+    QVERIFY(calculator.bottomBands());
+
+    auto paint = [&rect](const std::function<void(QPainter&)> &draw) {
+      QImage image(rect.size().toSize() + QSize(2, 2), QImage::Format_ARGB32_Premultiplied);
+      image.fill(Qt::white);
+      QPainter painter(&image);
+      painter.translate(-rect.topLeft() + QPointF(1, 1));
+      painter.setPen(Qt::NoPen);
+      draw(painter);
+      return image;
+    };
+
+    QImage stacked = paint([&](QPainter &painter) {
+      for (int i=0; i<contours.count(); i++)
+      {
+        painter.setBrush(colors[i]);
+        painter.drawPath(*contours[i]);
+      }
+    });
+
+    QImage banded = paint([&](QPainter &painter) {
+      for (int i=0; i<bands->count(); i++)
+      {
+        QList<QColor> covering;
+        for (int c : bands->covering(i))
+          covering.append(colors[c]);
+        painter.setBrush(ContourBands::composite(covering));
+        painter.drawPath(bands->band(i));
+      }
+    });
+
+    // Same colours, up to rounding and rasterization at the band edges
+    int differing = 0;
+    for (int y=0; y<stacked.height(); y++)
+      for (int x=0; x<stacked.width(); x++)
+      {
+        QColor a = stacked.pixelColor(x, y), b = banded.pixelColor(x, y);
+        if (qAbs(a.red() - b.red()) > 2 || qAbs(a.green() - b.green()) > 2 || qAbs(a.blue() - b.blue()) > 2)
+          differing++;
+      }
+    QVERIFY(differing < stacked.width() * stacked.height() / 100);
+  }
+
+  // Drag previews are filled without bands
+  calculator.calculate(true);
+  calculator.wait();
+  QVERIFY(!calculator.topBands());
+  QVERIFY(!calculator.bottomBands());
+}
+
+#include "foillogic/contourpolyline.hpp"
+void FoilTests::testContourPolylines()
+{
+  Foil foil;
+  FoilCalculator calculator(&foil);
+  calculator.calculateFull();
+  calculator.wait();
+  auto polylines = calculator.topPolylines();
+  auto contours = calculator.topContours();
+  QVERIFY(!polylines.isEmpty());
+  QCOMPARE(polylines.count(), contours.count());
+
+  for (int i=0; i<polylines.count(); i++)
+  {
+    const ContourPolyline &polyline = *polylines[i];
+
+    // Paths are built once, through every calculated point
+    QCOMPARE(calculator.topContours()[i], contours[i]);
+    QCOMPARE(contours[i]->elementCount(), polyline.pointCount());
+    QCOMPARE(contours[i]->elementAt(0).x, polyline.point(0).x());
+
+    // Squeezed single precision points take less than half the memory of the path elements
+    size_t pathBytes = contours[i]->elementCount() * sizeof(QPainterPath::Element);
+    QVERIFY(polyline.memoryUsage() * 2 < pathBytes);
+
+    // Simplified paths keep the islands and stay within the tolerance
+    int previous = polyline.pointCount();
+    for (qreal tolerance : { 0.01, 0.1, 1.0 })
+    {
+      QPainterPath simplified = polyline.simplified(tolerance);
+      QVERIFY(simplified.elementCount() <= previous);
+      previous = simplified.elementCount();
+
+      int islands = 0;
+      for (int j=0; j<simplified.elementCount(); j++)
+        islands += simplified.elementAt(j).isMoveTo();
+      QCOMPARE(islands, polyline.islandCount());
+
+      QRectF full = polyline.boundingRect();
+      QRectF rect = simplified.boundingRect();
+      QVERIFY(rect.adjusted(-tolerance, -tolerance, tolerance, tolerance).contains(full));
+    }
+    QVERIFY(previous < polyline.pointCount());
+  }
+}
+
+void FoilTests::testCurveFitting()
+{
+  Foil foil;
+  FoilCalculator calculator(&foil);
+  calculator.calculateFull();
+  calculator.wait();
+  auto polylines = calculator.topPolylines();
+
+  int points = 0;
+  for (const auto &polyline : polylines)
+    points += polyline->pointCount();
+
+  int previous = points;
+  for (qreal tolerance : { 0.05, 0.5 })
+  {
+    qreal error = -1;
+    QList<QPainterPath> curves = calculator.topCurves(tolerance, &error);
+    QCOMPARE(curves.count(), polylines.count());
+
+    int elements = 0;
+    for (int i=0; i<curves.count(); i++)
+    {
+      elements += curves[i].elementCount();
+      QVERIFY(curves[i].boundingRect().adjusted(-2*tolerance, -2*tolerance, 2*tolerance, 2*tolerance)
+              .contains(polylines[i]->boundingRect()));
+    }
+
+    // The error is measured on the fitted curves, sampled as polylines
+    QVERIFY(error >= 0);
+    QVERIFY(error < 2 * tolerance);
+    QVERIFY(elements < previous);
+    previous = elements;
+  }
+  // Beyond the calculation tolerance an order of magnitude fewer elements
+  QVERIFY(previous * 10 <= points);
+}
+
 QTR_ADD_TEST(FoilTests)
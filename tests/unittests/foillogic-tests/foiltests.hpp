@@ -33,6 +33,26 @@ private slots:
     void testSIdecoration();
     void testOutlineIO();
     void testAreaSweepCalc();
+    void testAdaptiveSections();
+    void testContourError();
+    void testParallelSections();
+    void testFeatureSampler();
+    void testThicknessLookup();
+    void testSymmetricContours();
+    void testGeometrySnapshot();
+    void testDerivedQuantities();
+    void testAsyncResults();
+    void testChangeTransaction();
+    void testDragCoalescing();
+    void testContourCacheRoundTrip();
+    void testContourCacheMisses();
+    void testContourCacheViewFill();
+    void testContourCacheLru();
+    void testLevelMemoization();
+    void testViewDetail();
+    void testBandPainting();
+    void testContourPolylines();
+    void testCurveFitting();
 };
 
 #endif // FOILTESTS_H
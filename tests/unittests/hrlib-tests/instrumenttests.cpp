@@ -0,0 +1,144 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "instrumenttests.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+
+#include "submodules/qtestrunner/qtestrunner.hpp"
+#include "hrlib/instrument/instrument.hpp"
+
+using namespace hrlib::instrument;
+
+void InstrumentTests::testZones()
+{
+  static Timer timer("InstrumentTests::zone");
+  std::vector<Timer*> timers = Timer::all();
+  QVERIFY(std::find(timers.begin(), timers.end(), &timer) != timers.end());
+
+  // Disabled zones record nothing
+  setEnabled(false);
+  { Zone zone(timer); }
+  QCOMPARE(timer.stats().count, uint64_t(0));
+
+  // Enabled zones record from any thread
+  setEnabled(true);
+  std::vector<std::thread> threads;
+  for (int i=0; i<4; i++)
+    threads.push_back(std::thread([]() {
+        for (int j=0; j<100; j++)
+          Zone zone(timer);
+      }));
+  for (auto &thread : threads)
+    thread.join();
+  {
+    Zone zone(timer);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    zone.end();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  setEnabled(false);
+
+  Timer::Stats stats = timer.take();
+  QCOMPARE(stats.count, uint64_t(401));
+  QVERIFY(stats.max >= 2000000);
+  QVERIFY(stats.max < 20000000);
+  QVERIFY(stats.total >= stats.max);
+  QCOMPARE(timer.stats().count, uint64_t(0));
+}
+void InstrumentTests::testTrace()
+{
+  static Timer timer("InstrumentTests::trace");
+  static Counter counter("InstrumentTests::counter");
+
+  // Zones outside a trace are not recorded
+  { Zone zone(timer); }
+
+  startTracing();
+  QVERIFY(tracing());
+  QVERIFY(!enabled());
+  {
+    Zone zone(timer);
+    counter.add(3);
+    counter.add(4);
+  }
+  uint32_t workerId = 0;
+  std::thread worker([&workerId]() {
+      workerId = threadId();
+      Zone zone(timer);
+    });
+  worker.join();
+  stopTracing();
+
+  // Zones after the trace are not recorded either
+  { Zone zone(timer); }
+  counter.set(0);
+
+  QVERIFY(workerId != threadId());
+  QCOMPARE(timer.stats().count, uint64_t(0));
+
+  std::ostringstream out;
+  QVERIFY(writeChromeTrace(out));
+  std::string json = out.str();
+
+  QJsonParseError error;
+  QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(json), &error);
+  QCOMPARE(error.error, QJsonParseError::NoError);
+
+  QSet<int> zoneThreads;
+  QList<int> counterValues;
+  for (const QJsonValue &value : doc.object()["traceEvents"].toArray())
+  {
+    QJsonObject event = value.toObject();
+    if (event["name"].toString() == "InstrumentTests::trace")
+    {
+      QCOMPARE(event["ph"].toString(), QString("X"));
+      QVERIFY(event["ts"].toDouble() >= 0);
+      QVERIFY(event["dur"].toDouble() >= 0);
+      zoneThreads.insert(event["tid"].toInt());
+    }
+    if (event["name"].toString() == "InstrumentTests::counter")
+    {
+      QCOMPARE(event["ph"].toString(), QString("C"));
+      counterValues.append(event["args"].toObject()["value"].toInt());
+    }
+  }
+  QCOMPARE(zoneThreads, QSet<int>({ int(threadId()), int(workerId) }));
+  QCOMPARE(counterValues, QList<int>({ 3, 7 }));
+
+  // A new trace starts empty
+  startTracing();
+  stopTracing();
+  out.str("");
+  QVERIFY(writeChromeTrace(out));
+  QVERIFY(out.str().find("InstrumentTests::") == std::string::npos);
+}
+
+QTR_ADD_TEST(InstrumentTests)
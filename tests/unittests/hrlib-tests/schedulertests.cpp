@@ -0,0 +1,125 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "schedulertests.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "submodules/qtestrunner/qtestrunner.hpp"
+#include "hrlib/concurrent/scheduler.hpp"
+
+using namespace hrlib::concurrent;
+
+void SchedulerTests::testNestedGroups()
+{
+  Scheduler scheduler(4);
+  std::atomic<int> count(0);
+
+  // Waiting inside a task helps running the inner tasks instead of blocking a worker
+  TaskGroup outer(scheduler);
+  for (int i=0; i<100; i++)
+    outer.run([&]() {
+        count++;
+        TaskGroup inner(scheduler);
+        for (int j=0; j<10; j++)
+          inner.run([&]() { count++; }, Priority::Interactive);
+        inner.wait();
+      });
+  outer.wait();
+
+  QCOMPARE(count.load(), 1100);
+}
+
+void SchedulerTests::testPriorityLanes()
+{
+  Scheduler scheduler(1);
+  std::atomic<bool> started(false), release(false);
+  std::atomic<int> done(0);
+  std::mutex mutex;
+  std::vector<int> order;
+
+  // Block the single worker while queueing
+  scheduler.submit([&]() {
+      started = true;
+      while (!release) std::this_thread::yield();
+    });
+  while (!started) std::this_thread::yield();
+
+  auto record = [&](int lane) {
+      return [&, lane]() {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(lane);
+          done++;
+        };
+    };
+  scheduler.submit(record(Priority::Background), Priority::Background);
+  scheduler.submit(record(Priority::Release), Priority::Release);
+  scheduler.submit(record(Priority::Interactive), Priority::Interactive);
+  scheduler.submit(record(Priority::Background), Priority::Background);
+  release = true;
+  while (done < 4) std::this_thread::yield();
+
+  std::vector<int> expected = {Priority::Interactive, Priority::Release, Priority::Background, Priority::Background};
+  QVERIFY(order == expected);
+}
+
+void SchedulerTests::testWaitLanes()
+{
+  Scheduler scheduler(1);
+  TaskGroup group(scheduler);
+
+  // A Background task of the group once, done before waiting below
+  group.run([]() {}, Priority::Background);
+  group.wait();
+
+  // Keep the single worker busy with a Release task of the group
+  std::atomic<bool> started(false), release(false);
+  group.run([&]() {
+      started = true;
+      while (!release) std::this_thread::yield();
+    }, Priority::Release);
+  while (!started) std::this_thread::yield();
+
+  // Queued for others, waiting for the group must not run it
+  std::atomic<bool> ran(false);
+  std::thread::id ranOn;
+  scheduler.submit([&]() {
+      ranOn = std::this_thread::get_id();
+      ran = true;
+    }, Priority::Background);
+
+  std::thread releaser([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      release = true;
+    });
+  group.wait();
+  releaser.join();
+
+  while (!ran) std::this_thread::yield();
+  QVERIFY(ranOn != std::this_thread::get_id());
+}
+
+QTR_ADD_TEST(SchedulerTests)
@@ -0,0 +1,111 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+#include "splinetests.hpp"
+
+#include <vector>
+#include <cmath>
+
+#include "submodules/qtestrunner/qtestrunner.hpp"
+#include "hrlib/math/spline.hpp"
+
+using namespace hrlib;
+
+void SplineTests::testBatchEvaluation()
+{
+  const int ndata = 12;
+  const int nval = 501;
+  std::vector<qreal> tdata(ndata), xdata(ndata), ydata(ndata);
+  for (int i=0; i<ndata; i++)
+    {
+      tdata[i] = i;
+      xdata[i] = 10*std::sin(1.3*i) + i;
+      ydata[i] = 5*std::cos(0.7*i);
+    }
+
+  // Start at 1 to cover the parameter range used for closing contours
+  for (qreal tstart : {0.0, 1.0})
+    {
+      qreal tstep = (ndata-1-tstart) / qreal(nval-1);
+      std::vector<qreal> x(nval), y(nval);
+
+      spline_b_val_batch(ndata, xdata.data(), ydata.data(), tstart, tstep, nval, x.data(), y.data());
+      for (int i=0; i<nval; i++)
+        {
+          qreal t = tstart + i*tstep;
+          QVERIFY(std::abs(x[i] - spline_b_val(ndata, xdata.data(), t)) < 1e-12);
+          QVERIFY(std::abs(y[i] - spline_b_val(ndata, ydata.data(), t)) < 1e-12);
+        }
+
+      spline_overhauser_uni_val_batch(ndata, tdata.data(), xdata.data(), ydata.data(), tstart, tstep, nval, x.data(), y.data());
+      for (int i=0; i<nval; i++)
+        {
+          qreal t = tstart + i*tstep;
+          QVERIFY(std::abs(x[i] - spline_overhauser_uni_val(ndata, tdata.data(), xdata.data(), t)) < 1e-12);
+          QVERIFY(std::abs(y[i] - spline_overhauser_uni_val(ndata, tdata.data(), ydata.data(), t)) < 1e-12);
+        }
+    }
+}
+
+void SplineTests::testBracketCursor()
+{
+  const int ndata = 9;
+  qreal tdata[ndata] = {0.0, 0.5, 0.6, 1.0, 2.5, 2.75, 4.0, 4.5, 7.0};
+
+  // Monotone sweep, then jumps in both directions, including values
+  // outside [tdata[0], tdata[ndata-1]] and on the knots themselves
+  std::vector<qreal> tvals;
+  for (int i=0; i<=200; i++)
+    tvals.push_back(-1.0 + 9.0*i/200);
+  for (qreal t : {6.0, 0.5, 4.0, -3.0, 7.0, 2.6, 2.6, 0.0, 10.0, 1.0})
+    tvals.push_back(t);
+
+  r8vec_bracket_cursor cursor;
+  for (qreal t : tvals)
+    {
+      int left, right, cLeft, cRight;
+      r8vec_bracket(ndata, tdata, t, &left, &right);
+      r8vec_bracket(ndata, tdata, t, &cLeft, &cRight, &cursor);
+      QCOMPARE(cLeft, left);
+      QCOMPARE(cRight, right);
+    }
+
+  // Evaluators give identical results with or without a cursor
+  qreal ydata[ndata];
+  for (int i=0; i<ndata; i++)
+    ydata[i] = std::sin(1.1*i);
+
+  r8vec_bracket_cursor bCursor, cCursor, lCursor;
+  for (qreal t : tvals)
+    {
+      QCOMPARE(spline_b_val(ndata, tdata, ydata, t, &bCursor), spline_b_val(ndata, tdata, ydata, t));
+      QCOMPARE(spline_constant_val(ndata, tdata, ydata, t, &cCursor), spline_constant_val(ndata, tdata, ydata, t));
+
+      qreal y, yp, cy, cyp;
+      spline_linear_val(ndata, tdata, ydata, t, &y, &yp);
+      spline_linear_val(ndata, tdata, ydata, t, &cy, &cyp, &lCursor);
+      QCOMPARE(cy, y);
+      QCOMPARE(cyp, yp);
+    }
+}
+
+QTR_ADD_TEST(SplineTests)
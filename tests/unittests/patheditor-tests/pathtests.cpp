@@ -0,0 +1,162 @@
+/****************************************************************************
+
+ Copyright (c) 2026, Hans Robeers
+ All rights reserved.
+
+ BSD 2-Clause License
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+****************************************************************************/
+
+
+#include "pathtests.hpp"
+#include "submodules/qtestrunner/qtestrunner.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+#include <QSet>
+#include "foillogic/foilio.hpp"
+#include "foillogic/profile.hpp"
+#include "patheditor/editablepath.hpp"
+#include "patheditor/path.hpp"
+#include "patheditor/line.hpp"
+#include "patheditor/pathpoint.hpp"
+#include "patheditor/curvepoint.hpp"
+#include "patheditor/pathsettings.hpp"
+#include "patheditor/pointhandlepool.hpp"
+
+using namespace patheditor;
+
+void PathTests::testPathBounds()
+{
+    Path path;
+    auto first = std::make_shared<CurvePoint>(0, 0);
+    auto second = std::make_shared<CurvePoint>(10, -5);
+    path.append(std::make_shared<Line>(first, second));
+    path.append(std::make_shared<Line>(second, std::make_shared<CurvePoint>(20, 0)));
+
+    // Repeated queries are served from the cache until a point moves
+    QRectF rect = path.controlPointRect();
+    QCOMPARE(rect, QRectF(0, -5, 20, 5));
+    quint64 moves = PathPoint::moveCount();
+    QCOMPARE(path.controlPointRect(), rect);
+    QCOMPARE(path.snapshot(), path.snapshot());
+    QCOMPARE(PathPoint::moveCount(), moves);
+
+    auto point = path.pathItems().last()->endPoint();
+    point->setPos(rect.right() + 10, point->y());
+    QVERIFY(PathPoint::moveCount() > moves);
+    QCOMPARE(path.controlPointRect().right(), rect.right() + 10);
+
+    // Appending invalidates too
+    auto line = std::make_shared<Line>(path.pathItems().last()->endPoint(),
+                                       std::make_shared<CurvePoint>(rect.right() + 20, 0));
+    path.append(line);
+    QCOMPARE(path.controlPointRect().right(), rect.right() + 20);
+}
+
+void PathTests::testHandleCreation()
+{
+    QList<std::shared_ptr<foillogic::Profile>> profiles;
+    QList<Path*> paths;
+    std::string dir = "testdata/profiles/";
+    for (const std::filesystem::directory_entry &p : std::filesystem::directory_iterator(dir))
+    {
+        if (p.path().extension().string()!=".dat")
+            continue;
+
+        std::ifstream ifs(p.path().string());
+        std::shared_ptr<foillogic::Profile> profile(foillogic::loadProfileDatStream(ifs));
+        QVERIFY(profile);
+        profiles.append(profile);
+        paths.append(profile->topProfile());
+    }
+    QVERIFY(!paths.isEmpty());
+
+    // A large path, as traced from an image
+    auto large = std::make_shared<Path>();
+    std::shared_ptr<PathPoint> point = std::make_shared<CurvePoint>(0, 0);
+    for (int i=1; i<=5000; i++)
+    {
+        auto next = std::make_shared<CurvePoint>(i, 50 * std::sin(i / 100.0));
+        large->append(std::make_shared<Line>(point, next));
+        point = next;
+    }
+    paths.append(large.get());
+
+    for (Path *path : paths)
+    {
+        // Points in region, all of them for a null region
+        auto pointsIn = [path](const QRectF &region) {
+            QSet<PathPoint*> points;
+            auto add = [&](const std::shared_ptr<PathPoint> &point) {
+                if (region.isNull() || region.contains(*point))
+                    points.insert(point.get());
+            };
+            for (auto item : path->pathItems())
+            {
+                add(item->startPoint());
+                add(item->endPoint());
+                for (auto controlPoint : item->controlPoints())
+                    add(controlPoint);
+            }
+            return points.count();
+        };
+
+        QRectF rect = path->controlPointRect();
+        QRectF viewport(rect.center(), rect.size() / 10);
+        viewport.translate(-viewport.width() / 2, -viewport.height() / 2);
+        // The viewport and half a viewport around it
+        auto region = [](const QRectF &visible) {
+            return visible.adjusted(-visible.width() / 2, -visible.height() / 2,
+                                    visible.width() / 2, visible.height() / 2);
+        };
+
+        // Without a viewport every point has a handle
+        EditablePath all(path);
+        all.syncHandles();
+        QCOMPARE(all.handlePool()->inUse(), pointsIn(QRectF()));
+        all.setEditable(false);
+        QCOMPARE(all.handlePool()->inUse(), 0);
+
+        // Only the points around the viewport have one
+        EditablePath culled(path);
+        culled.syncHandles(viewport);
+        QCOMPARE(culled.handlePool()->inUse(), pointsIn(region(viewport)));
+        QCOMPARE(culled.handlePool()->created(), culled.handlePool()->inUse());
+
+        // Panning reuses the released handles, only handles beyond those are created
+        QRectF panned = viewport.translated(viewport.width() / 4, 0);
+        culled.syncHandles(panned);
+        QCOMPARE(culled.handlePool()->inUse(), pointsIn(region(panned)));
+        QCOMPARE(culled.handlePool()->created(),
+                 qMax(pointsIn(region(viewport)), culled.handlePool()->inUse()));
+
+        // Non editable paths have no handles at all
+        EditablePath readOnly(path, PathSettings::Default(), false);
+        readOnly.syncHandles();
+        QCOMPARE(readOnly.handlePool()->created(), 0);
+    }
+
+    // Most of a large path is off screen
+    EditablePath culled(large.get());
+    QRectF rect = large->controlPointRect();
+    culled.syncHandles(QRectF(rect.topLeft(), rect.size() / 10));
+    QVERIFY(culled.handlePool()->inUse() < (large->pathItems().count() + 1) / 2);
+}
+
+QTR_ADD_TEST(PathTests)